@@ -0,0 +1,42 @@
+/**
+ * Adaptive spin-then-block semaphore for the short ferry/vehicle handoffs.
+ *
+ * A waiter first spins with a CPU relax hint for a self-tuning number of
+ * iterations and only then parks on a futex. The structure lives in shared
+ * memory, so it works between processes like a pshared sem_t.
+ */
+#ifndef ADAPTIVE_WAIT_H
+#define ADAPTIVE_WAIT_H
+#include <stdio.h>  // FILE
+#include <time.h>   // struct timespec
+
+// --- Spin limits (iterations) ---
+#define ADAPTIVE_SPIN_MIN 16
+#define ADAPTIVE_SPIN_MAX 4096
+#define ADAPTIVE_SPIN_DEFAULT 256
+
+// --- Structs ---
+typedef struct {
+    int count;                // Available tokens, also the futex word
+    int waiters;              // Number of parked waiters
+    int spin_limit;           // Current self-tuned spin budget
+    int spin_max;             // Upper bound for spin_limit (0 = never spin)
+    unsigned long fast_hits;  // Waits satisfied without spinning
+    unsigned long spin_hits;  // Waits satisfied while spinning
+    unsigned long parks;      // Waits that fell back to futex sleep
+} AdaptiveSem;
+
+//--- Futex helpers ---
+
+int futex_wait(int *addr, int expected, const struct timespec *timeout);
+int futex_wake(int *addr, int count);
+
+//--- Functions ---
+
+void adaptive_sem_init(AdaptiveSem *sem, unsigned int value, int spin_max);
+void adaptive_sem_wait(AdaptiveSem *sem);
+void adaptive_sem_post(AdaptiveSem *sem);
+int adaptive_sem_getvalue(AdaptiveSem *sem);
+void adaptive_sem_print_stats(AdaptiveSem *sem, const char *name, FILE *out);
+
+#endif // ADAPTIVE_WAIT_H
@@ -0,0 +1,65 @@
+/**
+ * Boarding policies: which vehicle class the ferry calls on board next.
+ *
+ * The ferry asks the selected policy once per boarded vehicle, passing a
+ * view of the port it is docked at. Policies only choose between the class
+ * queues of that port; the order within one queue is the order of the
+ * loading semaphore.
+ */
+#ifndef BOARDING_H
+#define BOARDING_H
+#include "vehicle_class.h"
+
+// --- Constants ---
+#define BOARDING_QUEUE_LEN 16384  // Arrival stamps kept per queue
+#define BOARDING_NONE -1          // Nothing can board
+#define DEFAULT_BOARDING_POLICY "alternate"
+#define MAX_WFQ_WEIGHT 1000
+#define WFQ_SCALE 1000000LL       // Virtual time of one unit at weight 1
+
+// --- Structs ---
+typedef struct {
+    long long stamps[BOARDING_QUEUE_LEN]; // Arrival times, oldest first
+    int head;                             // Index of the oldest stamp
+    int len;                              // Number of stamps
+} ArrivalQueue;
+
+typedef struct {
+    int classes;                            // Classes of the run
+    int waiting[MAX_VEHICLE_CLASSES];       // Waiting vehicles per class
+    long long head_ns[MAX_VEHICLE_CLASSES]; // Arrival of the oldest one
+    const int *size;                        // Deck units per class
+    int remaining;                          // Free units on the deck
+} BoardingView;
+
+typedef struct {
+    int policy;            // Index into BOARDING_POLICIES
+    int next_class;        // Alternation: class to try first
+    long long served[MAX_VEHICLE_CLASSES]; // WFQ: virtual service received
+    int weight[MAX_VEHICLE_CLASSES];       // WFQ: share of the deck
+    int size[MAX_VEHICLE_CLASSES];         // Deck units per class
+} BoardingState;
+
+typedef int (*BoardingPick)(const BoardingView *view, BoardingState *state);
+
+typedef struct {
+    const char *name;      // Name given to --policy
+    BoardingPick pick;     // Returns the class of the next vehicle or
+                           // BOARDING_NONE
+} BoardingPolicy;
+
+// --- Policies ---
+extern const BoardingPolicy BOARDING_POLICIES[];
+extern const int BOARDING_POLICY_COUNT;
+
+//--- Functions ---
+
+int boarding_policy_find(const char *name);
+void boarding_init(BoardingState *state, int policy,
+                   const ClassTable *classes);
+int boarding_pick(BoardingState *state, const BoardingView *view);
+void arrival_queue_push(ArrivalQueue *queue, long long arrived_ns);
+void arrival_queue_pop(ArrivalQueue *queue);
+long long arrival_queue_head(const ArrivalQueue *queue, long long fallback);
+
+#endif // BOARDING_H
@@ -0,0 +1,20 @@
+/**
+ * Online invariant checker: validates the events of a running simulation
+ * as they are logged and stops the run at the first violation.
+ */
+#ifndef CHECKER_H
+#define CHECKER_H
+#include "main.h"
+
+// --- Constants ---
+#define CHECK_WINDOW 16          // Events printed before a violation
+#define CHECK_TICK_MS 10         // Longest sleep between liveness checks
+
+//--- Functions ---
+
+void publish_event(SharedData *shared_data, long long number,
+                   char vehicle_type, int id, const char *action, int port);
+void checker_process(SharedData *shared_data, Config cfg);
+pid_t create_checker_process(SharedData *shared_data, Config cfg);
+
+#endif // CHECKER_H
@@ -0,0 +1,48 @@
+/**
+ * Slot-addressed ferry deck.
+ *
+ * Every boarding vehicle parks in the next free slot, and the slots fill
+ * the lanes in turn: slot s is position s / lanes of lane s % lanes. Each
+ * slot has its own wake, and the vehicles leave one after the other in a
+ * fixed order:
+ *
+ *     fifo  the front of every lane first, which is the boarding order
+ *     lifo  the back of every lane first, the lanes still in turn
+ *
+ * A leaving vehicle wakes the slot after its own, so every wake reaches
+ * exactly the vehicle that goes next.
+ */
+#ifndef DECK_H
+#define DECK_H
+
+// --- Constants ---
+#define MAX_DECK_SLOTS 100  // MAX_CAPACITY_PARCEL vehicles of one unit
+#define MAX_DECK_LANES 8
+#define DECK_NONE -1        // No slot
+#define DEFAULT_UNLOAD_ORDER "fifo"
+
+// --- Enums ---
+typedef enum {
+    UNLOAD_FIFO,  // First parked, first off
+    UNLOAD_LIFO,  // Last parked, first off
+} UnloadOrder;
+
+// --- Structs ---
+typedef struct {
+    int order;                  // UnloadOrder of the run
+    int lanes;                  // Lanes the slots are spread over
+    int count;                  // Occupied slots
+    int entry[MAX_DECK_SLOTS];  // Vehicle table entry parked in each slot
+    int next[MAX_DECK_SLOTS];   // Slot leaving after each slot, or DECK_NONE
+} Deck;
+
+//--- Functions ---
+
+int unload_order_find(const char *name);
+const char *unload_order_name(int order);
+void deck_init(Deck *deck, int order, int lanes);
+int deck_park(Deck *deck, int entry);
+int deck_plan_unload(Deck *deck);
+void deck_clear(Deck *deck);
+
+#endif // DECK_H
@@ -0,0 +1,43 @@
+/**
+ * Departure rules: how long the loaded ferry may wait for late arrivals.
+ *
+ * Holding trades vehicle latency for deck fill and fewer crossings. The
+ * ferry sleeps on the arrival sequence while it holds, so every arrival
+ * re-evaluates the rule without polling.
+ */
+#ifndef DEPARTURE_H
+#define DEPARTURE_H
+
+// --- Constants ---
+#define DEFAULT_DEPARTURE_RULE "immediate"
+#define DEFAULT_HOLD_US 1000
+#define MAX_HOLD_US 100000
+#define ARRIVAL_EWMA_WEIGHT 8  // A new gap counts 1/8
+
+// --- Enums ---
+typedef enum {
+    DEPART_IMMEDIATE,  // Leave once nobody else can board
+    DEPART_HOLD,       // Hold up to the hold time until min fill
+    DEPART_EWMA,       // Hold only while the next arrival is expected in time
+} DepartureRule;
+
+// --- Structs ---
+typedef struct {
+    int deck_units;          // Units loaded on the deck
+    int min_size;            // Units of the smallest vehicle class
+    int capacity;            // Ferry capacity in units
+    int arrivals_possible;   // Whether more vehicles can still arrive
+    long long now;           // Current time
+    long long deadline;      // End of the hold
+    long long arrival_gap_ns; // Smoothed gap between arrivals at the port
+} DepartureView;
+
+//--- Functions ---
+
+int departure_rule_find(const char *name);
+const char *departure_rule_name(int rule);
+int departure_should_hold(int rule, int min_fill, const DepartureView *view);
+long long arrival_gap_update(long long gap_ns, long long last_ns,
+                             long long arrived_ns);
+
+#endif // DEPARTURE_H
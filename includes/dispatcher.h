@@ -0,0 +1,17 @@
+/**
+ * Arrival dispatcher: releases the batch vehicles on their precomputed
+ * schedule, one clock_nanosleep deadline at a time.
+ */
+#ifndef DISPATCHER_H
+#define DISPATCHER_H
+#include "main.h"
+
+//--- Functions ---
+
+ArrivalSchedule *schedule_build(Config cfg);
+void schedule_await(SharedData *shared_data, Config cfg, int slot);
+void dispatcher_process(SharedData *shared_data);
+pid_t create_dispatcher_process(SharedData *shared_data, Config cfg);
+void print_dispatch_stats(SharedData *shared_data, FILE *out);
+
+#endif // DISPATCHER_H
@@ -0,0 +1,38 @@
+/**
+ * Bounded ring of logged events, shared between the simulation and the
+ * online checker.
+ *
+ * print_action() publishes every event while it holds the action counter
+ * semaphore, so there is one writer at a time and the events are in
+ * counter order. A full ring blocks the writer until the checker caught
+ * up: no event is ever dropped.
+ */
+#ifndef EVENT_RING_H
+#define EVENT_RING_H
+#include <time.h>  // struct timespec
+
+#include "invariants.h"
+
+// --- Constants ---
+#define EVENT_RING_LEN 4096  // Slots, a power of two
+
+// --- Structs ---
+typedef struct {
+    long long written;   // Events published
+    long long read;      // Events consumed
+    int write_seq;       // Bumped after a publish, futex word of the reader
+    int read_seq;        // Bumped after a consume, futex word of the writer
+    int reader_waiting;  // Whether the reader sleeps on write_seq
+    int writer_waiting;  // Whether the writer sleeps on read_seq
+    Event slots[EVENT_RING_LEN];
+} EventRing;
+
+//--- Functions ---
+
+EventRing *event_ring_create(void);
+void event_ring_push(EventRing *ring, const Event *event);
+long long event_ring_wait(EventRing *ring, const struct timespec *timeout);
+void event_ring_consume(EventRing *ring, long long upto);
+void event_ring_destroy(EventRing *ring);
+
+#endif // EVENT_RING_H
@@ -0,0 +1,57 @@
+/**
+ * libferry: the ferry simulation as an embeddable library.
+ *
+ * A simulation is created from a Config, run once, queried and destroyed:
+ *
+ *     Config cfg;
+ *     config_defaults(&cfg);
+ *     cfg.num_cars = 10; ...
+ *     FerrySim *sim = ferry_sim_create(&cfg, sink_none());
+ *     ferry_sim_run(sim);
+ *     ferry_sim_stats(sim, &stats);
+ *     ferry_sim_destroy(sim);
+ *
+ * The ferry and the vehicles are child processes of the caller, and
+ * ferry_sim_run() reaps every child of the calling process.
+ */
+#ifndef FERRY_H
+#define FERRY_H
+#include "main.h"
+
+// --- Structs ---
+typedef struct {
+    long long vehicles;         // Vehicles that crossed
+    long long actions;          // Logged actions
+    long long elapsed_ns;       // Run time
+    double vehicles_per_sec;    // Throughput
+    long long transit_p50_ns;   // Arrival to leaving, median
+    long long transit_p99_ns;   // Arrival to leaving, 99th percentile
+    long long wait_p99_ns;      // Arrival to boarding, 99th percentile
+    long long trips;            // Departures
+    long long empty_trips;      // Departures without any vehicle
+    double fill;                // Mean share of the deck used, 0 to 1
+    int stalled;                // Whether the watchdog stopped the run
+    long long idle_parks;       // Times the ferry parked with nothing to do
+    long long ferry_cpu_ns;     // CPU time used by the ferry
+    long long refused;          // Vehicles held back by a full port
+    long long overshoot_p99_ns; // Modelled sleeps waking late, 99th pct
+} FerryStats;
+
+typedef struct {
+    Config cfg;           // Settings, including the log sink
+    SharedData *shared;   // State shared with the simulation processes
+    LiveStats *live;      // Live stats segment, NULL if not published
+    int ran;              // Whether ferry_sim_run() was called
+} FerrySim;
+
+//--- Functions ---
+
+FerrySim *ferry_sim_create(const Config *cfg, FerrySink log);
+int ferry_sim_run(FerrySim *sim);
+void ferry_sim_stats(const FerrySim *sim, FerryStats *stats);
+void ferry_sim_print_stats(FerrySim *sim, FILE *out);
+int ferry_sim_count_vehicles(const FerrySim *sim, VehicleState state,
+                             int port);
+int ferry_sim_destroy(FerrySim *sim);
+
+#endif // FERRY_H
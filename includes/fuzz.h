@@ -0,0 +1,54 @@
+/**
+ * Schedule fuzzing: seeded yields and delays injected at every semaphore
+ * operation of the synchronization protocol.
+ */
+#ifndef FUZZ_H
+#define FUZZ_H
+#include <semaphore.h>  // sem_t
+
+#include "adaptive_wait.h"
+
+// --- Limits ---
+#define MAX_FUZZ_DELAY_US 10000
+#define FUZZ_DEFAULT_DELAY_US 100
+
+// --- Globals ---
+extern int fuzz_active;  // Set by fuzz_init() in processes that fuzz
+
+//--- Functions ---
+
+void fuzz_init(unsigned int seed, unsigned int stream, int max_delay_us);
+void fuzz_perturb(void);
+
+/**
+ * @brief Injection point, perturbs the schedule when fuzzing is active
+ */
+static inline void fuzz_point(void) {
+    if (fuzz_active) {
+        fuzz_perturb();
+    }
+}
+
+//--- Instrumented semaphore operations ---
+
+static inline void sync_wait(sem_t *sem) {
+    fuzz_point();
+    sem_wait(sem);
+}
+
+static inline void sync_post(sem_t *sem) {
+    sem_post(sem);
+    fuzz_point();
+}
+
+static inline void sync_handoff_wait(AdaptiveSem *sem) {
+    fuzz_point();
+    adaptive_sem_wait(sem);
+}
+
+static inline void sync_handoff_post(AdaptiveSem *sem) {
+    adaptive_sem_post(sem);
+    fuzz_point();
+}
+
+#endif // FUZZ_H
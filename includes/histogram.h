@@ -0,0 +1,34 @@
+/**
+ * Log-linear (HDR-style) latency histogram.
+ *
+ * Every power of two is split into HIST_SUB_BUCKETS linear buckets, so a
+ * recorded value is known within 1/HIST_SUB_BUCKETS of itself. Recording
+ * uses atomic increments and works on histograms in shared memory.
+ */
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+#include <stdio.h>  // FILE
+
+// --- Layout ---
+#define HIST_SUB_BITS 4
+#define HIST_SUB_BUCKETS (1 << HIST_SUB_BITS)
+#define HIST_MAGNITUDES 44  // Values up to 2^44 ns (about 4.9 hours)
+#define HIST_BUCKETS (HIST_MAGNITUDES * HIST_SUB_BUCKETS)
+
+// --- Structs ---
+typedef struct {
+    unsigned long long counts[HIST_BUCKETS];  // Values per bucket
+    unsigned long long total;                 // Number of recorded values
+    long long sum;                            // Sum of recorded values
+    long long max;                            // Largest recorded value
+} Histogram;
+
+//--- Functions ---
+
+void histogram_init(Histogram *hist);
+void histogram_record(Histogram *hist, long long value);
+void histogram_merge(Histogram *dst, const Histogram *src);
+long long histogram_percentile(const Histogram *hist, double percentile);
+void histogram_print(const Histogram *hist, const char *name, FILE *out);
+
+#endif // HISTOGRAM_H
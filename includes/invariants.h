@@ -0,0 +1,72 @@
+/**
+ * Incremental checker of the output invariants: counter continuity, deck
+ * capacity, boarding/leaving order and port consistency.
+ *
+ * Events are fed one at a time and the checker keeps a constant amount of
+ * state per vehicle, so it can validate a finished log as well as a live
+ * event stream. A vehicle making several crossings goes through arrival,
+ * boarding and leaving once per crossing, arriving again where it left.
+ */
+#ifndef INVARIANTS_H
+#define INVARIANTS_H
+#include <stdio.h>  // FILE
+
+#include "vehicle_class.h"
+
+// --- Constants ---
+#define INVARIANT_ERROR_LEN 160
+
+// --- Enums ---
+typedef enum {
+    EVENT_STARTED,
+    EVENT_ARRIVED,    // "arrived to", vehicle or ferry
+    EVENT_BOARDING,
+    EVENT_LEAVING_IN, // vehicle leaving the ferry
+    EVENT_LEAVING,    // ferry leaving a port
+    EVENT_FINISH,
+    EVENT_ACTION_INVALID, // Not a logged action
+} EventAction;
+
+// --- Structs ---
+typedef struct {
+    long long number;    // Action counter value
+    char type;           // 'P' or the letter of a vehicle class
+    int id;              // Vehicle id, 0 for the ferry
+    EventAction action;  // What happened
+    int port;            // Port of the action, -1 if none
+} Event;
+
+typedef struct {
+    int capacity;          // Ferry capacity in units
+    int crossings;         // Crossings every vehicle makes
+    ClassTable classes;    // Expected vehicles of each class
+    long long next_number; // Expected action number of the next event
+    int ferry_started;     // Whether the ferry has started
+    int ferry_finished;    // Whether the ferry has finished
+    int ferry_docked;      // Whether the ferry is at a port
+    int ferry_port;        // Port of the last ferry arrival
+    int stop;              // Number of the current ferry stop
+    int stop_load;         // Units boarded at the current stop
+    int stop_boarded;      // Vehicles boarded at the current stop
+    int on_deck;           // Vehicles currently on the ferry
+    unsigned char *state;  // Per vehicle: last seen action + 1, 0 = none
+    signed char *port;     // Per vehicle: port it arrived to
+    int *boarded_stop;     // Per vehicle: stop at which it boarded
+    int *crossed;          // Per vehicle: crossings completed
+    char error[INVARIANT_ERROR_LEN]; // Description of the first violation
+} InvariantChecker;
+
+//--- Functions ---
+
+EventAction event_action_find(const char *name);
+int parse_event_line(const char *line, Event *event);
+int format_event(const Event *event, char *buf, size_t size);
+int invariant_init(InvariantChecker *checker, const ClassTable *classes,
+                   int capacity, int crossings);
+int invariant_feed(InvariantChecker *checker, const Event *event);
+int invariant_finish(InvariantChecker *checker);
+void invariant_destroy(InvariantChecker *checker);
+int invariant_check_file(FILE *log, const ClassTable *classes, int capacity,
+                         int crossings, char *error, size_t error_size);
+
+#endif // INVARIANTS_H
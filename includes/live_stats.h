@@ -0,0 +1,65 @@
+/**
+ * Live metrics published through a named shared-memory segment.
+ *
+ * A sampler process copies the simulation counters into the segment under
+ * a seqlock. Readers such as ferrystat never take the simulation's locks
+ * and retry a snapshot that raced with an update.
+ */
+#ifndef LIVE_STATS_H
+#define LIVE_STATS_H
+#include <string.h>     // memcpy
+#include <sys/types.h>  // pid_t
+
+#include "vehicle_class.h"
+
+// --- Constants ---
+#define LIVE_STATS_VERSION 2
+#define LIVE_HISTORY 120          // Sampled queue depths kept
+#define LIVE_DEFAULT_INTERVAL_MS 100
+#define MAX_LIVE_INTERVAL_MS 60000
+
+// --- Structs ---
+typedef struct {
+    unsigned int seq;           // Seqlock sequence, odd while writing
+    int version;                // LIVE_STATS_VERSION
+    pid_t pid;                  // PID of the simulation
+    int capacity;               // Ferry capacity in units
+    long long start_ns;         // Monotonic start time of the run
+    long long updated_ns;       // Monotonic time of this sample
+    long long expected;         // Vehicles of the run, -1 while streaming
+    long long unloaded;         // Vehicles that crossed
+    long long actions;          // Logged actions
+    long long trips;            // Completed ferry cycles
+    double action_rate;         // Actions per second over the last interval
+    int ferry_port;             // Current ferry port
+    int deck_units;             // Units loaded on the deck
+    int deck_vehicles;          // Vehicles loaded on the deck
+    int classes;                // Vehicle classes of the run
+    char class_letter[MAX_VEHICLE_CLASSES];           // Letter in the log
+    char class_name[MAX_VEHICLE_CLASSES][CLASS_NAME_LEN]; // Name in reports
+    int waiting[MAX_VEHICLE_CLASSES][2]; // Waiting vehicles, [class][port]
+    int finished;               // Whether the run has finished
+    int history_len;            // Valid entries in queue_history
+    int history_head;           // Index of the next history entry
+    int queue_history[LIVE_HISTORY][2]; // Sampled waiting vehicles per port
+} LiveStats;
+
+/**
+ * @brief Copies a consistent snapshot of the live stats
+ * @param live Mapped stats segment
+ * @param snapshot Where to store the copy
+ *
+ * Spins while the writer is in the middle of an update.
+ */
+static inline void live_stats_read(const LiveStats *live, LiveStats *snapshot) {
+    unsigned int before;
+    unsigned int after;
+    do {
+        before = __atomic_load_n(&live->seq, __ATOMIC_ACQUIRE);
+        memcpy(snapshot, live, sizeof(*snapshot));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        after = __atomic_load_n(&live->seq, __ATOMIC_RELAXED);
+    } while ((before & 1) || before != after);
+}
+
+#endif // LIVE_STATS_H
@@ -1,110 +1,289 @@
-/**
- * Author: Serhij Čepil (sipxi)
- * FIT VUT Student
- * https://github.com/sipxi
- * Date: 18/05/2025
- * Time spent: 63h
- */
-#ifndef MAIN_H
-#define MAIN_H
-#include <semaphore.h>  // sem_t
-#include <stdio.h>      // input output
-#include <stdlib.h>     //stol
-#include <string.h>
-#include <sys/mman.h>   // mmap
-#include <sys/types.h>  // pid_t
-#include <sys/wait.h>   // wait
-#include <time.h>       // for rand
-#include <unistd.h>     // sleep
-// --- Argument count ---
-#define EXPECTED_ARGS 6
-
-// --- Limits ---
-#define MAX_NUM_TRUCKS 10000
-#define MAX_NUM_CARS 10000
-
-// --- Capacity constraints ---
-#define MIN_CAPACITY_PARCEL 3
-#define MAX_CAPACITY_PARCEL 100
-
-// --- Timing constraints (microseconds) ---
-#define MIN_VEHICLE_ARRIVAL_US 0
-#define MAX_VEHICLE_ARRIVAL_US 10000
-#define MIN_FERRY_ARRIVAL_US 0
-#define MAX_FERRY_ARRIVAL_US 1000
-
-// --- Constants ---
-#define TRUCK_SIZE 3
-#define CAR_SIZE 1
-#define PARSE_BASE_DECIMAL 10
-// --- Structs ---
-typedef struct {
-    int num_trucks;
-    int num_cars;
-    int capacity_of_ferry;
-    int max_vehicle_arrival_us;
-    int max_ferry_arrival_us;
-    FILE *log_file;
-} Config;
-
-typedef struct {
-    int action_counter;      // Global action counter
-    int ferry_port;          // Current port of the ferry (0 or 1)
-    int ferry_capacity;      // Ferry capacity
-    int waiting_trucks[2];   // Number of trucks waiting at each port
-    int waiting_cars[2];     // Number of cars waiting at each port
-    int loaded_trucks;       // Number of trucks currently on the ferry
-    int loaded_cars;         // Number of cars currently on the ferry
-    int vehicles_to_unload;  // Number of vehicles to unload
-    int vehicles_unloaded;   // Number of vehicles unloaded
-    int next_vehicle_is_truck; // Next vehicle to unload 
-    int total_vehicles_unloaded; // Total number of vehicles unloaded
-    sem_t action_counter_sem;  // Semaphore for synchronizing action counter
-    sem_t unload_vehicle;     // Semaphore for unloading vehicles
-    sem_t lock_mutex;  // Semaphore for synchronizing shared data
-    sem_t vehicle_boarding; // Semaphore for vehicle boarding
-    sem_t unload_complete_sem;  // Semaphore for unload completion
-    sem_t load_truck[2]; // Semaphores for loading trucks at each port
-    sem_t load_car[2]; // Semaphores for loading cars at each port
-    sem_t loading_done; // Semaphore for loading completion
-} SharedData;
-
-//--- Helpers ---
-
-int parse_uint(const char *value_str, int min, int max, const char *arg_name,
-               int *result);
-int destroy_semaphore(sem_t *sem, const char *sem_name);
-int rand_range(int min, int max);
-int init_semaphore(sem_t *sem, int pshared, unsigned int value,
-                   const char *sem_name);
-void wait_for_children();
-FILE *file_init(const char *filename);
-void wait_for_loading_signal(SharedData *shared_data, char vehicle_type,
-                             int port);
-void board_vehicle(SharedData *shared_data, Config cfg, char vehicle_type,
-                   int id);
-void add_vehicle_to_port(SharedData *shared_data, char vehicle_type, int port);
-void ferry_to_another_port(SharedData *shared_data, FILE *log_file);
-int unload_vehicles(SharedData *shared_data);
-int try_load_vehicle(SharedData *shared_data, int port, int is_truck,
-                     int *remaining_capacity, int *vehicle_count);
-//--- Functions ---
-
-int cleanup(SharedData *shared_data);
-int load_ferry(SharedData *shared_data, Config cfg);
-int parse_args(int argc, char const *argv[], Config *cfg);
-void print_action(SharedData *shared_data, FILE *log_file,
-                  const char vehicle_type, int vehicle_id, const char *action,
-                  int port);
-void ferry_process(SharedData *shared_data, Config cfg);
-void vehicle_process(SharedData *shared_data, Config cfg, char vehicle_type,
-                     int id, int port);
-
-SharedData *init_shared_data(Config cfg);
-void print_shared_data(SharedData *shared_data);
-
-void create_ferry_process(SharedData *shared_data, Config cfg);
-void create_vehicle_process(SharedData *shared_data, Config cfg,
-                            const char vehicle_type);
-
+/**
+ * Author: Serhij Čepil (sipxi)
+ * FIT VUT Student
+ * https://github.com/sipxi
+ * Date: 18/05/2025
+ * Time spent: 63h
+ */
+#ifndef MAIN_H
+#define MAIN_H
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE     // cpu_set_t
+#endif
+#include <limits.h>     // INT_MAX
+#include <semaphore.h>  // sem_t
+#include <stddef.h>     // offsetof
+#include <stdio.h>      // input output
+#include <stdlib.h>     //stol
+#include <string.h>
+#include <sys/mman.h>   // mmap
+#include <sys/types.h>  // pid_t
+#include <sys/wait.h>   // wait
+#include <time.h>       // for rand
+#include <unistd.h>     // sleep
+
+#include "adaptive_wait.h"
+#include "boarding.h"
+#include "deck.h"
+#include "departure.h"
+#include "event_ring.h"
+#include "fuzz.h"
+#include "histogram.h"
+#include "live_stats.h"
+#include "placement.h"
+#include "scenario.h"
+#include "schedule.h"
+#include "sink.h"
+#include "trips.h"
+#include "vehicle_table.h"
+#include "timing.h"
+#include "trace.h"
+#include "vehicle_class.h"
+// --- Argument count ---
+#define EXPECTED_ARGS 6
+
+// --- Limits ---
+#define MAX_NUM_TRUCKS 10000
+#define MAX_NUM_CARS 10000
+#define MAX_QUEUE_LIMIT (MAX_NUM_CARS + MAX_NUM_TRUCKS)
+#define MAX_ROUND_TRIPS 1000
+
+// --- Capacity constraints ---
+#define MIN_CAPACITY_PARCEL 3
+#define MAX_CAPACITY_PARCEL 100
+
+// --- Timing constraints (microseconds) ---
+#define MIN_VEHICLE_ARRIVAL_US 0
+#define MAX_VEHICLE_ARRIVAL_US 10000
+#define MIN_FERRY_ARRIVAL_US 0
+#define MAX_FERRY_ARRIVAL_US 1000
+#define MAX_DWELL_US 10000
+
+// --- Constants ---
+#define TRUCK_SIZE 3
+#define CAR_SIZE 1
+#define PARSE_BASE_DECIMAL 10
+#define EVENT_HISTORY 64    // Logged lines kept for stall dumps
+#define EVENT_LINE_LEN 64   // Maximum length of one logged line
+#define VEHICLE_DUMP_IDS 16 // Waiting vehicles listed per port in dumps
+#define OPTION_PREFIX "--"
+
+// --- Modelled sleeps, indexes of SharedData.overshoot ---
+#define SLEEP_CROSSING 0   // The ferry crossing to the other port
+#define SLEEP_ARRIVAL 1    // A vehicle driving to its port
+#define SLEEP_DWELL 2      // A vehicle staying at a port between crossings
+#define SLEEP_KINDS 3
+// --- Structs ---
+typedef struct {
+    int num_trucks;
+    int num_cars;
+    int capacity_of_ferry;
+    int max_vehicle_arrival_us;
+    int max_ferry_arrival_us;
+    // Optional "--name=value" settings
+    int stats;     // Print a statistics report to stderr at exit
+    int spin_max;  // Spin budget of the adaptive handoffs, 0 = always park
+    int ferry_cpu;         // CPU the ferry is pinned to
+    int ferry_fifo;        // SCHED_FIFO priority of the ferry, 0 = off
+    int ferry_nice_boost;  // Nice levels the ferry gains, 0 = off
+    int numa_node;         // Preferred NUMA node of the shared data
+    int watchdog_ms;       // Stall interval of the watchdog, 0 = off
+    int watchdog_events;   // Logged events printed by a stall dump
+    int seed;              // Seed of all random draws, 0 = seed by PID
+    int fuzz_seed;         // Seed of the schedule fuzzer, 0 = off
+    int fuzz_delay_us;     // Longest delay injected by the fuzzer
+    int report_ms;         // Interval of progress reports, 0 = off
+    const char *stream_path;  // Arrival stream ("-" = stdin), NULL = batch
+    int live_ms;              // Sampling interval of the live stats
+    const char *live_stats_name;  // Name of the live stats segment
+    const char *trip_log_path;    // CSV file with one row per trip
+    const char *trace_path;       // Chrome trace of the phases, NULL = off
+    const char *policy_name;      // Boarding policy, see boarding.h
+    int boarding_policy;          // Index of the boarding policy
+    int wfq_car_weight;           // WFQ share of cars
+    int wfq_truck_weight;         // WFQ share of trucks
+    const char *depart_name;      // Departure rule, see departure.h
+    int departure_rule;           // The parsed departure rule
+    int hold_us;                  // Longest departure hold
+    const char *unload_name;      // Unload order, see deck.h
+    int unload_order;             // The parsed unload order
+    int deck_lanes;               // Lanes the deck slots are spread over
+    int min_fill;                 // Fill in percent that ends a hold
+    int idle_park;                // Park the ferry while nothing is queued
+    int dispatch;                 // Release arrivals from one dispatcher
+    int check;                    // Check the invariants while running
+    int queue_limit;              // Vehicles queued per port, 0 = unbounded
+    int timer_slack_ns;           // Timer slack of the run, 0 = kernel default
+    int round_trips;              // Round trips per vehicle, 0 = one crossing
+    int dwell_us;                 // Longest stay at a port between crossings
+    int crossings;                // Crossings per vehicle, from round_trips
+    const char *ports_name;       // How the ferry reaches the ports
+    int port_link;                // The parsed link, see port_server.h
+    const char *scenario_path;    // Load profile of the batch, see scenario.h
+    Scenario scenario;            // The parsed scenario, count 0 = none
+    const char *classes_spec;     // Vehicle classes beyond car and truck
+    ClassTable classes;           // Every class of the run, see vehicle_class.h
+    const char *vehicle_cpus_list;  // CPUs for vehicles and helpers
+    cpu_set_t vehicle_cpus;         // Parsed vehicle_cpus_list
+    FerrySink log;                  // Where the action log goes
+} Config;
+
+typedef struct {
+    const char *name;  // Option name without the "--" prefix
+    size_t offset;     // Offset of the int field in Config
+    int min;           // Minimum allowed value
+    int max;           // Maximum allowed value
+} IntOption;
+
+typedef struct {
+    const char *name;  // Option name without the "--" prefix
+    size_t offset;     // Offset of the const char * field in Config
+} StrOption;
+
+typedef struct {
+    long long action_counter; // Global action counter
+    int ferry_port;          // Current port of the ferry (0 or 1)
+    int ferry_capacity;      // Ferry capacity
+    ClassTable classes;      // Vehicle classes of the run
+    int waiting[MAX_VEHICLE_CLASSES][2]; // Vehicles waiting, [class][port]
+    int loaded[MAX_VEHICLE_CLASSES];     // Vehicles on the ferry per class
+    int vehicles_to_unload;  // Number of vehicles to unload
+    int vehicles_unloaded;   // Number of vehicles unloaded
+    BoardingState boarding;  // State of the boarding policy
+    Deck deck;               // Slot of every vehicle on the ferry
+    ArrivalQueue arrivals[MAX_VEHICLE_CLASSES][2]; // Arrival stamps,
+                                                   // [class][port]
+    ArrivalSchedule *schedule;   // Batch arrivals, NULL = vehicles sleep
+    VehicleTable *vehicles;      // State of every vehicle
+    EventRing *events;           // Logged events for the checker, or NULL
+    int check_failed;            // Set when the checker stopped the run
+    int arrival_seq;             // Bumped on every arrival, futex word
+    int ferry_holding;           // Whether the ferry sleeps on arrival_seq
+    int ferry_idle;              // Whether it is parked with nothing to do
+    int peak_waiting[2];         // Longest queue seen at each port
+    int queue_limit;             // Vehicles queued per port, 0 = unbounded
+    long long refused[2];        // Vehicles a full port held back
+    long long refused_ns[2];     // Time they were held, summed per port
+    long long refused_ns_max;    // Longest time a vehicle was held
+    long long idle_parks;        // Times the ferry parked idle
+    long long arrived_vehicles;  // Arrivals at a port, one per crossing
+    long long last_arrival_ns[2]; // Latest arrival at each port
+    long long arrival_gap_ns[2]; // Smoothed gap between arrivals per port
+    int departure_rule;          // Configured departure rule
+    long long departure_holds;   // Departures the ferry held
+    long long held_vehicles;     // Vehicles boarded while holding
+    long long total_vehicles_unloaded; // Total number of vehicles unloaded
+    long long expected_vehicles; // Crossings of the run, -1 while streaming
+    int crossings;               // Crossings per vehicle
+    long long latency_ns_total;  // Arrival to leaving, summed over vehicles
+    long long latency_count;     // Vehicles counted in latency_ns_total
+    long long start_ns;          // Monotonic time the run started
+    long long end_ns;            // Monotonic time the ferry finished
+    Histogram wait_hist[MAX_VEHICLE_CLASSES][2];    // Arrival to boarding,
+                                                    // [class][port]
+    Histogram transit_hist[MAX_VEHICLE_CLASSES][2]; // Arrival to leaving
+    Histogram overshoot[SLEEP_KINDS]; // Wakeups past the modelled deadline
+    int port_link;               // How the ferry reaches the ports
+    long long port_messages[2];  // Messages over the link to each port
+    Histogram port_rtt[2];       // Round trip of a load request per port
+    long long worst_wait_ns;     // Longest arrival to boarding wait
+    char worst_type;             // Type of the worst-starved vehicle
+    int worst_id;                // Id of the worst-starved vehicle
+    int worst_port;              // Port of the worst-starved vehicle
+    TripSummary trip_summary;    // Trip aggregates, written by the ferry
+    long long ferry_cycles;      // Completed ferry cycles
+    long long cycle_ns_total;    // Time spent at ports, summed over cycles
+    long long cycle_ns_min;      // Shortest cycle at a port
+    long long cycle_ns_max;      // Longest cycle at a port
+    long long ferry_cpu_ns;      // CPU time used by the ferry process
+    int finished;                // Set once the ferry has finished
+    int stalled;                 // Set when the watchdog killed the run
+    int aborted;                 // Set when the run was stopped unfinished
+    pid_t ferry_pid;             // The ferry, as seen by the parent
+    pid_t port_pid[2];           // Server of each linked port, 0 if none
+    pid_t sim_pgid;              // Process group of ferry and vehicles
+    int keep_events;             // Whether recent_events is maintained
+    char recent_events[EVENT_HISTORY][EVENT_LINE_LEN]; // Last logged lines
+    sem_t action_counter_sem;  // Semaphore for synchronizing action counter
+    sem_t slot_sem[MAX_DECK_SLOTS]; // Wakes the vehicle parked in a slot
+    sem_t lock_mutex;  // Semaphore for synchronizing shared data
+    AdaptiveSem vehicle_boarding; // Handoff for vehicle boarding
+    sem_t unload_complete_sem;  // Semaphore for unload completion
+    sem_t load_sem[MAX_VEHICLE_CLASSES][2]; // Loading calls, [class][port]
+    sem_t admit_sem[2];       // Free places in the queue of each port
+    AdaptiveSem loading_done; // Handoff for loading completion
+} SharedData;
+
+//--- Helpers ---
+
+int parse_uint(const char *value_str, int min, int max, const char *arg_name,
+               int *result);
+int destroy_semaphore(sem_t *sem, const char *sem_name);
+int rand_range_r(unsigned int *state, int min, int max);
+int rand_range(int min, int max);
+int init_semaphore(sem_t *sem, int pshared, unsigned int value,
+                   const char *sem_name);
+void wait_for_children(SharedData *shared_data);
+void reap_child(SharedData *shared_data, pid_t pid);
+void abort_run(SharedData *shared_data);
+int run_over(SharedData *shared_data);
+void apply_ferry_placement(Config cfg);
+void apply_helper_placement(Config cfg);
+unsigned int process_stream(int cls, int id);
+unsigned int stream_seed(int seed, unsigned int stream);
+void seed_process(Config cfg, int cls, int id);
+void record_ferry_cycle(SharedData *shared_data, long long cycle_ns);
+void model_delay(SharedData *shared_data, int kind, long long start_ns,
+                 int max_us);
+void wait_for_loading_signal(SharedData *shared_data, int cls, int port);
+int board_vehicle(SharedData *shared_data, Config cfg, int cls, int id,
+                  int entry);
+int admit_vehicle(SharedData *shared_data, int cls, int port, int entry);
+void add_vehicle_to_port(SharedData *shared_data, int cls, int port,
+                         long long arrived_ns);
+void notify_arrival(SharedData *shared_data);
+void ferry_to_another_port(SharedData *shared_data, const FerrySink *log);
+int unload_vehicles(SharedData *shared_data);
+int try_load_vehicle(SharedData *shared_data, int port, int cls,
+                     int *remaining_capacity, int *vehicle_count);
+int deck_units(const SharedData *shared_data);
+int deck_vehicles(const SharedData *shared_data);
+int port_waiting(const SharedData *shared_data, int port);
+//--- Functions ---
+
+int cleanup(SharedData *shared_data);
+void fill_boarding_view(SharedData *shared_data, int port,
+                        int remaining_capacity, BoardingView *view);
+int load_port(SharedData *shared_data, int port, int remaining_capacity);
+int load_ferry(SharedData *shared_data, Config cfg);
+void wait_for_boarding(SharedData *shared_data, int vehicles);
+void hold_departure(SharedData *shared_data, Config cfg);
+int park_idle(SharedData *shared_data, Config cfg);
+void config_defaults(Config *cfg);
+int config_validate(Config *cfg);
+int parse_option(const char *arg, Config *cfg);
+int parse_args(int argc, char const *argv[], Config *cfg);
+void print_action(SharedData *shared_data, const FerrySink *log,
+                  const char vehicle_type, int vehicle_id, const char *action,
+                  int port);
+void ferry_process(SharedData *shared_data, Config cfg);
+int ferry_unload(SharedData *shared_data);
+void record_trip(SharedData *shared_data, TripLog *trips, TripRecord *trip);
+void finish_ferry(SharedData *shared_data, Config cfg);
+void vehicle_process(SharedData *shared_data, Config cfg, int cls, int id,
+                     int port);
+void cross_once(SharedData *shared_data, Config cfg, int cls, int id,
+                int entry, int port);
+
+SharedData *init_shared_data(Config cfg);
+void print_shared_data(SharedData *shared_data);
+void print_stats(SharedData *shared_data, FILE *out);
+void print_latency_stats(SharedData *shared_data, FILE *out);
+
+pid_t create_ferry_process(SharedData *shared_data, Config cfg);
+void create_vehicle_process(SharedData *shared_data, Config cfg, int cls);
+int run_simulation(SharedData *shared_data, Config cfg, LiveStats *live);
+pid_t spawn_vehicle(SharedData *shared_data, Config cfg, int cls, int id,
+                    int port);
+
 #endif
\ No newline at end of file
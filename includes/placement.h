@@ -0,0 +1,27 @@
+/**
+ * CPU affinity, scheduling class and NUMA placement controls.
+ */
+#ifndef PLACEMENT_H
+#define PLACEMENT_H
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE  // cpu_set_t
+#endif
+#include <sched.h>      // cpu_set_t
+#include <stddef.h>     // size_t
+
+// --- Limits ---
+#define MAX_FIFO_PRIORITY 99
+#define MAX_NICE_BOOST 20
+#define MAX_NUMA_NODE 63
+#define PLACEMENT_UNSET -1
+
+//--- Functions ---
+
+int parse_cpu_list(const char *list, cpu_set_t *set);
+int pin_to_cpu(int cpu);
+int pin_to_cpu_set(const cpu_set_t *set);
+int set_fifo_priority(int priority);
+int boost_priority(int boost);
+int bind_to_numa_node(void *addr, size_t length, int node);
+
+#endif // PLACEMENT_H
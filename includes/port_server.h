@@ -0,0 +1,102 @@
+/**
+ * Port servers: each port as its own process, reached over sockets.
+ *
+ * With --ports=unix or --ports=tcp every port runs a server process that
+ * holds the queues of that port. A vehicle connects to the server of the
+ * port it arrives at and waits there: the server admits it, queues it by
+ * class, calls it on board and later tells it to leave. The ferry asks
+ * the server of its port with one batched request per step and gets one
+ * reply, answered from the server's own state:
+ *
+ *     LOAD    call vehicles into the room left on the deck, in the order
+ *             of the boarding policy, and reply once they are on board
+ *     UNLOAD  let the vehicles this port put on the deck leave, in the
+ *             unload order, and reply once they are off
+ *     STATUS  report the queue and the arrivals of the port
+ *     WAIT    reply on the next arrival, or when CANCEL comes first
+ *
+ * The admission under --queue-limit, the boarding policy state and the
+ * deck order live in the servers. The shared mapping still carries the
+ * action log, the vehicle table and the statistics, which the servers and
+ * vehicles publish to, but no decision of the ferry or a server reads
+ * them. unix links are abstract Unix domain sockets, tcp links loopback
+ * connections with Nagle's algorithm off; either way all processes still
+ * run on one host.
+ */
+#ifndef PORT_SERVER_H
+#define PORT_SERVER_H
+#include "main.h"
+
+// --- Constants ---
+#define DEFAULT_PORT_LINK "shared"
+
+// --- Enums ---
+typedef enum {
+    PORT_LINK_SHARED,  // The ferry boards through the shared mapping
+    PORT_LINK_UNIX,    // Unix domain socket per port
+    PORT_LINK_TCP,     // Loopback TCP connection per port
+} PortLinkMode;
+
+typedef enum {
+    PORT_REQUEST_LOAD,    // Call vehicles into the room left on the deck
+    PORT_REQUEST_UNLOAD,  // Let the vehicles boarded at the port leave
+    PORT_REQUEST_STATUS,  // Report the queue of the port
+    PORT_REQUEST_WAIT,    // Reply on the next arrival
+    PORT_REQUEST_CANCEL,  // Answer a pending WAIT, then this request
+    PORT_REQUEST_STOP,    // The run is over
+} PortRequestType;
+
+typedef enum {
+    PORT_VEHICLE_ARRIVE,   // Vehicle: asks for a place in the queue
+    PORT_VEHICLE_HOLD,     // Server: the queue is full, wait for ADMIT
+    PORT_VEHICLE_ADMIT,    // Server: the vehicle may arrive
+    PORT_VEHICLE_ARRIVED,  // Vehicle: logged its arrival, now queued
+    PORT_VEHICLE_BOARD,    // Server: go on board
+    PORT_VEHICLE_BOARDED,  // Vehicle: logged its boarding
+    PORT_VEHICLE_LEAVE,    // Server: leave the deck
+    PORT_VEHICLE_LEFT,     // Vehicle: logged its leaving
+} PortVehicleMessageType;
+
+// --- Messages, sent as they are in memory ---
+typedef struct {
+    int type;       // PortRequestType
+    int remaining;  // LOAD: free units on the deck
+} PortRequest;
+
+typedef struct {
+    int called;     // LOAD: vehicles on board, UNLOAD: vehicles that left
+    int boarded[MAX_VEHICLE_CLASSES]; // LOAD: vehicles on board per class
+    int waiting;    // Vehicles waiting at the port
+    long long arrivals;       // Arrivals at the port so far
+    long long arrival_gap_ns; // Smoothed gap between arrivals at the port
+    long long messages;       // Vehicle messages since the last reply
+} PortReply;
+
+typedef struct {
+    int type;       // PortVehicleMessageType
+    int cls;        // ARRIVE: class of the vehicle
+    int entry;      // ARRIVE: vehicle table entry of the vehicle
+    long long time_ns; // ARRIVED: when the vehicle arrived
+} PortVehicleMessage;
+
+//--- Functions ---
+
+int port_link_find(const char *name);
+const char *port_link_name(int mode);
+int port_links_open(int mode);
+void port_links_close(void);
+void port_links_attach_ferry(void);
+int port_link_load(SharedData *shared_data, int port, int remaining);
+int port_link_unload(SharedData *shared_data, int port);
+int port_link_status(SharedData *shared_data, int port, PortReply *status);
+int port_link_wait(SharedData *shared_data, const int ports[2],
+                   long long deadline);
+void port_links_stop(void);
+int port_link_arrive(int port, int cls, int entry, int *held);
+int port_link_send(int fd, int type, long long time_ns);
+int port_link_await(int fd, int type);
+void port_server_process(SharedData *shared_data, Config cfg, int port);
+pid_t create_port_process(SharedData *shared_data, Config cfg, int port);
+void print_port_link_stats(SharedData *shared_data, FILE *out);
+
+#endif // PORT_SERVER_H
@@ -0,0 +1,19 @@
+/**
+ * Sampler process publishing the live stats segment.
+ */
+#ifndef PUBLISHER_H
+#define PUBLISHER_H
+#include "live_stats.h"
+#include "main.h"
+
+//--- Functions ---
+
+LiveStats *live_stats_create(const char *name);
+void live_stats_destroy(LiveStats *live, const char *name);
+void live_stats_sample(LiveStats *live, SharedData *shared_data,
+                       long long *last_actions);
+void publisher_process(SharedData *shared_data, Config cfg, LiveStats *live);
+pid_t create_publisher_process(SharedData *shared_data, Config cfg,
+                               LiveStats *live);
+
+#endif // PUBLISHER_H
@@ -0,0 +1,63 @@
+/**
+ * Workload scenarios: load profiles for the batch vehicles.
+ *
+ * A scenario file describes the arrivals of a run as segments, one per
+ * line:
+ *
+ *     KIND START_US END_US CARS TRUCKS [port1=PCT] [ramp=FROM:TO] [size=N]
+ *
+ * KIND is one of
+ *     backlog  every vehicle is queued at START_US
+ *     even     evenly spaced arrivals
+ *     poisson  random arrivals, the rate ramps from FROM to TO (default 1:1)
+ *     burst    groups of size N (default 10) at even intervals
+ *
+ * port1 is the share of the segment arriving at port 1 in percent (default
+ * 50). Empty lines and lines starting with '#' are ignored. The counts of
+ * every segment are fixed, so the numbers of cars and trucks of the run
+ * are known before anything is drawn.
+ */
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+// --- Limits ---
+#define MAX_SCENARIO_SEGMENTS 32
+#define MAX_SCENARIO_US 60000000   // Latest arrival, one minute
+#define MAX_SCENARIO_RAMP 1000
+#define DEFAULT_BURST_SIZE 10
+
+// --- Enums ---
+typedef enum {
+    SEGMENT_BACKLOG,
+    SEGMENT_EVEN,
+    SEGMENT_POISSON,
+    SEGMENT_BURST,
+} SegmentKind;
+
+// --- Structs ---
+typedef struct {
+    SegmentKind kind;
+    int start_us;    // Start of the segment after the start of the run
+    int end_us;      // End of the segment
+    int cars;        // Cars arriving in the segment
+    int trucks;      // Trucks arriving in the segment
+    int port1_pct;   // Share arriving at port 1
+    int ramp_from;   // Poisson: relative rate at the start
+    int ramp_to;     // Poisson: relative rate at the end
+    int burst_size;  // Burst: vehicles per burst
+} ScenarioSegment;
+
+typedef struct {
+    int count;       // Segments, 0 = no scenario
+    int cars;        // Cars over all segments
+    int trucks;      // Trucks over all segments
+    ScenarioSegment segments[MAX_SCENARIO_SEGMENTS];
+} Scenario;
+
+//--- Functions ---
+
+int scenario_load(const char *path, Scenario *scenario);
+void scenario_draw(const Scenario *scenario, long long *due_ns, int *port,
+                   unsigned int *state);
+
+#endif // SCENARIO_H
@@ -0,0 +1,42 @@
+/**
+ * Precomputed arrival schedule of the batch vehicles.
+ *
+ * The arrival times are drawn before the run and kept in shared memory
+ * as a structure of arrays sorted by time. A single dispatcher releases
+ * the vehicles in that order, so the run arms one timer at a time instead
+ * of one per vehicle and its arrival schedule is known exactly.
+ */
+#ifndef SCHEDULE_H
+#define SCHEDULE_H
+#include <stddef.h>  // size_t
+
+// --- Slot states, also the futex word of a slot ---
+#define SLOT_PENDING 0   // Not yet due
+#define SLOT_WAITING 1   // The vehicle sleeps on the slot
+#define SLOT_RELEASED 2  // Due, the vehicle may arrive
+
+// --- Structs ---
+typedef struct {
+    int count;               // Scheduled vehicles, see vehicle_class.h
+    int dispatched;          // Whether a dispatcher releases the slots
+    long long *due_ns;       // Arrival time after the start, ascending
+    int *vehicle;            // Vehicle index of each slot
+    int *port;               // Port of each slot
+    int *state;              // SLOT_* of each slot
+    int *slot_of;            // Slot of each vehicle index
+    long long timers;        // Deadlines the dispatcher slept until
+    long long late_ns_total; // Release lateness summed over the slots
+    long long late_ns_max;   // Worst release lateness
+    size_t map_len;          // Length of the mapping holding all of it
+} ArrivalSchedule;
+
+//--- Functions ---
+
+ArrivalSchedule *schedule_create(int count);
+int schedule_sort(ArrivalSchedule *schedule);
+int schedule_slot(const ArrivalSchedule *schedule, int vehicle);
+void schedule_wait(ArrivalSchedule *schedule, int slot);
+void schedule_release(ArrivalSchedule *schedule, int slot);
+void schedule_destroy(ArrivalSchedule *schedule);
+
+#endif // SCHEDULE_H
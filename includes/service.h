@@ -0,0 +1,32 @@
+/**
+ * Service mode: vehicle arrivals streamed over stdin or a FIFO, and
+ * periodic throughput and latency reports.
+ */
+#ifndef SERVICE_H
+#define SERVICE_H
+#include "main.h"
+
+// --- Limits ---
+#define MAX_REPORT_MS 3600000
+#define STREAM_BUFFER_LEN 4096
+
+// --- Structs ---
+typedef struct {
+    long long last_ns;             // Time of the previous report
+    long long last_unloaded;       // Vehicles unloaded at the previous report
+    long long last_actions;        // Action counter at the previous report
+    long long last_latency_ns;     // Latency sum at the previous report
+    long long last_latency_count;  // Latency count at the previous report
+} ProgressReport;
+
+//--- Functions ---
+
+void progress_init(ProgressReport *report, SharedData *shared_data);
+void progress_report(ProgressReport *report, SharedData *shared_data,
+                     FILE *out);
+int handle_stream_line(SharedData *shared_data, Config cfg, char *line,
+                       int next_id[MAX_VEHICLE_CLASSES]);
+int stream_arrivals(SharedData *shared_data, Config cfg);
+void wait_with_reports(SharedData *shared_data, Config cfg);
+
+#endif // SERVICE_H
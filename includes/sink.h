@@ -0,0 +1,47 @@
+/**
+ * Output sinks for the action log.
+ *
+ * Every process of a simulation writes its lines through the same sink
+ * while holding action_counter_sem, so writes never interleave. A memory
+ * sink lives in shared memory, which lets the creator of the simulation
+ * read the whole log back without touching the file system.
+ */
+#ifndef SINK_H
+#define SINK_H
+#include <stddef.h>  // size_t
+#include <stdio.h>   // FILE
+
+// --- Enums ---
+typedef enum {
+    SINK_NONE,    // Discard the log
+    SINK_FILE,    // Write to a stdio stream
+    SINK_MEMORY,  // Append to a shared buffer
+} SinkKind;
+
+// --- Structs ---
+typedef struct {
+    size_t capacity;  // Bytes the buffer holds
+    size_t length;    // Bytes written
+    size_t dropped;   // Bytes that did not fit
+    char data[];      // The log, not NUL-terminated
+} SinkBuffer;
+
+typedef struct {
+    SinkKind kind;       // Where the lines go
+    FILE *file;          // SINK_FILE: the stream
+    int owns_file;       // SINK_FILE: whether sink_close() closes it
+    SinkBuffer *buffer;  // SINK_MEMORY: shared mapping
+} FerrySink;
+
+//--- Functions ---
+
+FerrySink sink_none(void);
+FerrySink sink_file(FILE *file);
+int sink_open_path(FerrySink *sink, const char *path);
+int sink_open_memory(FerrySink *sink, size_t capacity);
+void sink_write(const FerrySink *sink, const char *line, size_t len);
+const char *sink_text(const FerrySink *sink, size_t *len);
+void sink_reset(FerrySink *sink);
+void sink_close(FerrySink *sink);
+
+#endif // SINK_H
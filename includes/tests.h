@@ -1,10 +1,12 @@
-#ifndef TESTS_ARGS_H
-#define TESTS_ARGS_H
-
-// --- Test Assertions ---
-void run_args_test();
-
-// --- Run All Tests ---
-void run_all_tests();
-
+#ifndef TESTS_ARGS_H
+#define TESTS_ARGS_H
+
+// --- Test Assertions ---
+int run_args_test();
+int run_simulation_tests();
+int run_perf_tests(const char *baseline_path);
+
+// --- Run All Tests ---
+int run_all_tests();
+
 #endif // TESTS_ARGS_H
\ No newline at end of file
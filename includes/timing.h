@@ -0,0 +1,23 @@
+/**
+ * Monotonic clock helpers shared by the simulation and its statistics.
+ *
+ * Modelled delays sleep until absolute deadlines of the monotonic clock,
+ * so a late wakeup never pushes later deadlines back, and report how far
+ * past the deadline they woke.
+ */
+#ifndef TIMING_H
+#define TIMING_H
+
+// --- Constants ---
+#define NS_PER_US 1000LL
+#define NS_PER_MS 1000000LL
+#define NS_PER_SEC 1000000000LL
+#define MAX_TIMER_SLACK_NS 1000000
+
+//--- Functions ---
+
+long long now_ns(void);
+long long sleep_until(long long deadline_ns);
+long timer_slack_set(long slack_ns);
+
+#endif // TIMING_H
@@ -0,0 +1,35 @@
+/**
+ * Phase timeline tracing in the Chrome trace event format.
+ *
+ * With --trace=PATH every traced process records its spans, such as a
+ * ferry phase or a vehicle waiting at its port, as complete events in a
+ * process-local buffer. The buffer is appended to the file when it fills
+ * and when the process exits, so tracing adds no locking to the run. The
+ * file loads in chrome://tracing and in the Perfetto UI.
+ *
+ * The ferry is one track of the "ferry" process, every vehicle is one
+ * track of the "vehicles" process. Timestamps are monotonic, in
+ * microseconds since the start of the run.
+ */
+#ifndef TRACE_H
+#define TRACE_H
+
+// --- Constants ---
+#define TRACE_BUFFER_LEN 16384  // Bytes buffered before a write
+#define TRACE_EVENT_LEN 192     // Longest formatted event
+#define TRACE_NAME_LEN 32       // Longest track name
+
+// --- Trace processes, the groups of tracks ---
+#define TRACE_FERRY 1
+#define TRACE_VEHICLES 2
+
+//--- Functions ---
+
+int trace_open(const char *path, long long origin_ns);
+int trace_close(void);
+void trace_track(int group, int track, const char *name);
+void trace_span(const char *name, long long begin_ns, long long end_ns,
+                int port);
+void trace_flush(void);
+
+#endif // TRACE_H
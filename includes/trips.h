@@ -0,0 +1,63 @@
+/**
+ * Trip-level efficiency analytics kept by the ferry.
+ *
+ * The ferry appends one record per departure to a process-local log and
+ * summarizes it into shared memory when it finishes.
+ */
+#ifndef TRIPS_H
+#define TRIPS_H
+#include <stddef.h>  // size_t
+#include <stdio.h>   // FILE
+
+// --- Enums ---
+typedef enum {
+    PHASE_CROSSING,   // Sailing to the port
+    PHASE_UNLOADING,  // Releasing the deck until everyone left
+    PHASE_LOADING,    // Calling vehicles on board
+    PHASE_WAITING,    // Waiting for boarded vehicles to report
+    PHASE_HOLDING,    // Holding the departure for late arrivals
+    PHASE_PARKED,     // Parked idle until a vehicle arrived anywhere
+    PHASE_COUNT,
+} TripPhase;
+
+// --- Structs ---
+typedef struct {
+    int port;                        // Port the ferry departed from
+    int cars;                        // Cars loaded
+    int trucks;                      // Trucks loaded
+    int others;                      // Vehicles of the added classes loaded
+    int units;                       // Deck units used
+    long long phase_ns[PHASE_COUNT]; // Time spent in each phase
+    int messages;                    // Messages over the port links
+    long long rtt_ns;                // Round trips to the port servers
+} TripRecord;
+
+typedef struct {
+    TripRecord *records;  // Recorded trips
+    size_t count;         // Number of recorded trips
+    size_t capacity;      // Allocated records
+} TripLog;
+
+typedef struct {
+    long long trips;                 // Departures
+    long long empty_trips;           // Departures without any vehicle
+    long long units_used;            // Deck units used over all trips
+    long long units_offered;         // Capacity offered over all trips
+    long long vehicles;              // Vehicles carried
+    long long elapsed_ns;            // Ferry run time
+    long long phase_ns[PHASE_COUNT]; // Time per phase over all trips
+    long long messages;              // Messages over the port links
+    long long rtt_ns;                // Round trips to the port servers
+} TripSummary;
+
+//--- Functions ---
+
+const char *trip_phase_name(TripPhase phase);
+int trip_log_append(TripLog *log, const TripRecord *record);
+void trip_log_free(TripLog *log);
+void trip_log_summarize(const TripLog *log, int capacity,
+                        long long elapsed_ns, TripSummary *summary);
+int trip_log_write_csv(const TripLog *log, const char *path);
+void trip_summary_print(const TripSummary *summary, FILE *out);
+
+#endif // TRIPS_H
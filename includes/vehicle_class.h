@@ -0,0 +1,54 @@
+/**
+ * Vehicle classes: the kinds of vehicle a run carries.
+ *
+ * Every class has its own letter in the log, deck size, batch size and
+ * arrival window, and its own queue at each port. Cars and trucks are
+ * always classes 0 and 1, sized by the positional arguments; --classes
+ * appends more, e.g. "bus:B:5:20,van:V:2:50:4000".
+ *
+ * Vehicles are indexed by class, then by id: the cars first, then the
+ * trucks, then every added class in order.
+ */
+#ifndef VEHICLE_CLASS_H
+#define VEHICLE_CLASS_H
+
+// --- Limits ---
+#define MAX_VEHICLE_CLASSES 8
+#define MAX_CLASS_VEHICLES 10000
+#define CLASS_NAME_LEN 16
+
+// --- Built-in classes ---
+#define CLASS_CAR 0
+#define CLASS_TRUCK 1
+#define CLASS_NONE -1  // The ferry, or an unknown letter
+
+// --- Structs ---
+typedef struct {
+    char name[CLASS_NAME_LEN]; // Name in reports
+    char letter;               // Type in the log
+    int size;                  // Deck units of one vehicle
+    int count;                 // Vehicles of the class in the batch
+    int max_arrival_us;        // Arrivals are uniform in [0, max_arrival_us]
+    int weight;                // WFQ share of the deck
+    int first;                 // Vehicle index of id 1
+} VehicleClass;
+
+typedef struct {
+    int count;                 // Classes in use
+    int vehicles;              // Vehicles of the batch over all classes
+    int min_size;              // Smallest deck size of any class
+    VehicleClass classes[MAX_VEHICLE_CLASSES];
+} ClassTable;
+
+//--- Functions ---
+
+void class_table_init(ClassTable *table);
+void class_table_builtin(ClassTable *table, int num_cars, int num_trucks);
+int class_table_add(ClassTable *table, const VehicleClass *vehicle_class);
+int class_table_parse(ClassTable *table, const char *spec,
+                      int max_arrival_us);
+int class_find(const ClassTable *table, char letter);
+int class_vehicle_index(const ClassTable *table, int cls, int id);
+int class_of_vehicle(const ClassTable *table, int vehicle, int *id);
+
+#endif // VEHICLE_CLASS_H
@@ -0,0 +1,56 @@
+/**
+ * Per-vehicle state table in shared memory.
+ *
+ * One entry per vehicle, kept as a structure of arrays: every vehicle
+ * writes only its own entry at each transition, and queries such as "who
+ * waits at port 1" are linear scans over a few dense arrays instead of a
+ * parse of the action log.
+ */
+#ifndef VEHICLE_TABLE_H
+#define VEHICLE_TABLE_H
+#include <stddef.h>  // size_t
+#include <stdio.h>   // FILE
+
+#include "vehicle_class.h"
+
+// --- Vehicle states, in the order a vehicle goes through them ---
+typedef enum {
+    VEHICLE_UNUSED,   // No process yet
+    VEHICLE_STARTED,  // On its way to the port
+    VEHICLE_HELD,     // Refused by a full port, waiting for room
+    VEHICLE_WAITING,  // Queued at the port
+    VEHICLE_ON_DECK,  // Boarded the ferry
+    VEHICLE_CROSSED,  // Left the ferry at the other port
+    VEHICLE_STATE_COUNT,
+} VehicleState;
+
+#define VEHICLE_ANY -1  // Matches every port or class in a count
+
+// --- Structs ---
+typedef struct {
+    int classes;              // Vehicle classes tracked
+    int first[MAX_VEHICLE_CLASSES + 1]; // Entry of id 1 per class, then count
+    char letter[MAX_VEHICLE_CLASSES];   // Log letter per class
+    char name[MAX_VEHICLE_CLASSES][CLASS_NAME_LEN]; // Name per class
+    int count;                // Entries, by class and then by id
+    unsigned char *class_id;  // Class of each entry
+    unsigned char *port;      // Port each vehicle arrives at
+    unsigned char *state;     // VehicleState of each entry
+    long long *state_ns[VEHICLE_STATE_COUNT]; // When each state was entered
+    size_t map_len;           // Length of the mapping holding all of it
+} VehicleTable;
+
+//--- Functions ---
+
+VehicleTable *vehicle_table_create(const ClassTable *classes, int streaming);
+int vehicle_table_index(const VehicleTable *table, int cls, int id);
+void vehicle_table_start(VehicleTable *table, int index, int port,
+                         long long when_ns);
+void vehicle_table_set(VehicleTable *table, int index, VehicleState state,
+                       long long when_ns);
+int vehicle_table_count(const VehicleTable *table, VehicleState state,
+                        int port, int cls);
+void vehicle_table_print(const VehicleTable *table, int max_ids, FILE *out);
+void vehicle_table_destroy(VehicleTable *table);
+
+#endif // VEHICLE_TABLE_H
@@ -0,0 +1,20 @@
+/**
+ * Stall watchdog: watches the action counter heartbeat and kills the
+ * simulation when it stops advancing.
+ */
+#ifndef WATCHDOG_H
+#define WATCHDOG_H
+#include "main.h"
+
+// --- Limits ---
+#define MAX_WATCHDOG_MS 60000
+#define WATCHDOG_DEFAULT_EVENTS 16
+#define WATCHDOG_MIN_TICK_US 1000
+
+//--- Functions ---
+
+void print_recent_events(SharedData *shared_data, int count, FILE *out);
+void watchdog_process(SharedData *shared_data, Config cfg);
+pid_t create_watchdog_process(SharedData *shared_data, Config cfg);
+
+#endif // WATCHDOG_H
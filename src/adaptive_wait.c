@@ -0,0 +1,163 @@
+#include "adaptive_wait.h"
+
+#include <linux/futex.h>  // FUTEX_WAIT, FUTEX_WAKE
+#include <sys/syscall.h>  // SYS_futex
+#include <unistd.h>       // syscall, sysconf
+
+/**
+ * @brief Hints the CPU that we are in a spin loop
+ */
+static inline void cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#else
+    __asm__ __volatile__("" ::: "memory");
+#endif
+}
+
+/**
+ * @brief Sleeps on a shared futex word while it holds the expected value
+ * @param addr Futex word
+ * @param expected Value the word must hold for the caller to sleep
+ * @param timeout Relative timeout, or NULL to sleep until woken
+ * @return 0 when woken, -1 on timeout, value mismatch or signal
+ */
+int futex_wait(int *addr, int expected, const struct timespec *timeout) {
+    return syscall(SYS_futex, addr, FUTEX_WAIT, expected, timeout, NULL, 0);
+}
+
+/**
+ * @brief Wakes up to count processes sleeping on a shared futex word
+ * @param addr Futex word
+ * @param count Maximum number of processes to wake
+ * @return Number of processes woken, -1 on error
+ */
+int futex_wake(int *addr, int count) {
+    return syscall(SYS_futex, addr, FUTEX_WAKE, count, NULL, NULL, 0);
+}
+
+/**
+ * @brief Tries to take one token without blocking
+ * @param sem Pointer to the semaphore
+ * @return 1 if a token was taken, 0 otherwise
+ */
+static int try_take(AdaptiveSem *sem) {
+    int value = __atomic_load_n(&sem->count, __ATOMIC_ACQUIRE);
+    while (value > 0) {
+        if (__atomic_compare_exchange_n(&sem->count, &value, value - 1, 0,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Moves the spin budget an eighth of the way towards a target
+ * @param sem Pointer to the semaphore
+ * @param target Desired spin budget
+ */
+static void tune_spin_limit(AdaptiveSem *sem, int target) {
+    int limit = __atomic_load_n(&sem->spin_limit, __ATOMIC_RELAXED);
+    if (target > sem->spin_max) {
+        target = sem->spin_max;
+    }
+    limit += (target - limit) / 8;
+    __atomic_store_n(&sem->spin_limit, limit, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Initializes an adaptive semaphore
+ * @param sem Pointer to the semaphore
+ * @param value Initial number of tokens
+ * @param spin_max Upper bound of the spin budget, 0 disables spinning
+ *
+ * Spinning only pays off when the poster can run at the same time as the
+ * waiter, so on a single CPU the spin phase is disabled.
+ */
+void adaptive_sem_init(AdaptiveSem *sem, unsigned int value, int spin_max) {
+    if (sysconf(_SC_NPROCESSORS_ONLN) < 2) {
+        spin_max = 0;
+    }
+    sem->count = value;
+    sem->waiters = 0;
+    sem->spin_max = spin_max;
+    sem->spin_limit = spin_max < ADAPTIVE_SPIN_DEFAULT ? spin_max
+                                                       : ADAPTIVE_SPIN_DEFAULT;
+    sem->fast_hits = 0;
+    sem->spin_hits = 0;
+    sem->parks = 0;
+}
+
+/**
+ * @brief Takes one token, spinning briefly before sleeping on the futex
+ * @param sem Pointer to the semaphore
+ *
+ * A hit while spinning pulls the budget towards twice the spins it needed,
+ * a park pulls it back towards ADAPTIVE_SPIN_MIN.
+ */
+void adaptive_sem_wait(AdaptiveSem *sem) {
+    if (try_take(sem)) {
+        __atomic_add_fetch(&sem->fast_hits, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    int limit = __atomic_load_n(&sem->spin_limit, __ATOMIC_RELAXED);
+    for (int spins = 1; spins <= limit; spins++) {
+        cpu_relax();
+        if (try_take(sem)) {
+            __atomic_add_fetch(&sem->spin_hits, 1, __ATOMIC_RELAXED);
+            tune_spin_limit(sem, 2 * spins + ADAPTIVE_SPIN_MIN);
+            return;
+        }
+    }
+
+    __atomic_add_fetch(&sem->parks, 1, __ATOMIC_RELAXED);
+    if (sem->spin_max > 0) {
+        tune_spin_limit(sem, ADAPTIVE_SPIN_MIN);
+    }
+
+    __atomic_add_fetch(&sem->waiters, 1, __ATOMIC_SEQ_CST);
+    while (!try_take(sem)) {
+        futex_wait(&sem->count, 0, NULL);
+    }
+    __atomic_sub_fetch(&sem->waiters, 1, __ATOMIC_SEQ_CST);
+}
+
+/**
+ * @brief Releases one token and wakes a parked waiter if there is one
+ * @param sem Pointer to the semaphore
+ */
+void adaptive_sem_post(AdaptiveSem *sem) {
+    __atomic_add_fetch(&sem->count, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&sem->waiters, __ATOMIC_SEQ_CST) > 0) {
+        futex_wake(&sem->count, 1);
+    }
+}
+
+/**
+ * @brief Returns the number of currently available tokens
+ * @param sem Pointer to the semaphore
+ */
+int adaptive_sem_getvalue(AdaptiveSem *sem) {
+    return __atomic_load_n(&sem->count, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Prints how the waits on the semaphore were satisfied
+ * @param sem Pointer to the semaphore
+ * @param name Name of the semaphore for the report
+ * @param out Output stream
+ */
+void adaptive_sem_print_stats(AdaptiveSem *sem, const char *name, FILE *out) {
+    unsigned long total = sem->fast_hits + sem->spin_hits + sem->parks;
+    double denom = total > 0 ? (double)total : 1.0;
+    fprintf(out,
+            "  %-18s waits %lu: fast %.1f%%, spin %.1f%%, park %.1f%% "
+            "(spin limit %d/%d)\n",
+            name, total, 100.0 * sem->fast_hits / denom,
+            100.0 * sem->spin_hits / denom, 100.0 * sem->parks / denom,
+            sem->spin_limit, sem->spin_max);
+}
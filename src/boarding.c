@@ -0,0 +1,226 @@
+#include "boarding.h"
+
+#include "main.h"
+
+/**
+ * @brief Checks whether a vehicle of the class waits and fits on the deck
+ */
+static int fits(const BoardingView *view, int cls) {
+    return view->waiting[cls] > 0 && view->remaining >= view->size[cls];
+}
+
+/**
+ * @brief Picks the fitting class whose oldest vehicle arrived first
+ */
+static int oldest_fitting(const BoardingView *view) {
+    int best = BOARDING_NONE;
+    for (int cls = 0; cls < view->classes; cls++) {
+        if (fits(view, cls) &&
+            (best == BOARDING_NONE || view->head_ns[cls] < view->head_ns[best])) {
+            best = cls;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Takes turns between the classes, skipping those that cannot board
+ *
+ * The original boarding order: the preferred class moves on after every
+ * boarded vehicle, whichever class it was. With cars and trucks only, it
+ * alternates between the two.
+ */
+static int pick_alternate(const BoardingView *view, BoardingState *state) {
+    for (int i = 0; i < view->classes; i++) {
+        int cls = (state->next_class + i) % view->classes;
+        if (fits(view, cls)) {
+            state->next_class = (state->next_class + 1) % view->classes;
+            return cls;
+        }
+    }
+    return BOARDING_NONE;
+}
+
+/**
+ * @brief Boards strictly in arrival order
+ *
+ * A vehicle that does not fit blocks the ones that arrived after it, so
+ * the ferry may leave with free units.
+ */
+static int pick_fifo(const BoardingView *view, BoardingState *state) {
+    (void)state;
+    int oldest = BOARDING_NONE;
+    for (int cls = 0; cls < view->classes; cls++) {
+        if (view->waiting[cls] > 0 &&
+            (oldest == BOARDING_NONE ||
+             view->head_ns[cls] < view->head_ns[oldest])) {
+            oldest = cls;
+        }
+    }
+    if (oldest == BOARDING_NONE) {
+        return BOARDING_NONE;
+    }
+    return fits(view, oldest) ? oldest : BOARDING_NONE;
+}
+
+/**
+ * @brief Boards the largest vehicles that fit first, trucks before cars
+ */
+static int pick_trucks_first(const BoardingView *view, BoardingState *state) {
+    (void)state;
+    int best = BOARDING_NONE;
+    for (int cls = 0; cls < view->classes; cls++) {
+        if (fits(view, cls) &&
+            (best == BOARDING_NONE || view->size[cls] > view->size[best])) {
+            best = cls;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Boards the longest-waiting vehicle that fits
+ *
+ * Like fifo, but a vehicle that does not fit is skipped instead of
+ * blocking the queue.
+ */
+static int pick_longest_waiting(const BoardingView *view,
+                                BoardingState *state) {
+    (void)state;
+    return oldest_fitting(view);
+}
+
+/**
+ * @brief Weighted fair queueing of deck units between the classes
+ *
+ * Each class is charged its size divided by its weight per boarded vehicle
+ * and the fitting class with the least virtual service goes first, ties
+ * going to the longest-waiting one. An idle class is caught up with the
+ * busy ones, so it cannot bank service.
+ */
+static int pick_wfq(const BoardingView *view, BoardingState *state) {
+    // Catch up to the least-served busy class, or the most-served if idle
+    long long floor = -1;
+    for (int cls = 0; cls < view->classes; cls++) {
+        if (view->waiting[cls] > 0 &&
+            (floor == -1 || state->served[cls] < floor)) {
+            floor = state->served[cls];
+        }
+    }
+    for (int cls = 0; floor == -1 && cls < view->classes; cls++) {
+        floor = state->served[cls] > floor ? state->served[cls] : floor;
+    }
+    for (int cls = 0; cls < view->classes; cls++) {
+        if (view->waiting[cls] == 0 && state->served[cls] < floor) {
+            state->served[cls] = floor;
+        }
+    }
+
+    int best = BOARDING_NONE;
+    for (int cls = 0; cls < view->classes; cls++) {
+        if (!fits(view, cls)) {
+            continue;
+        }
+        if (best == BOARDING_NONE || state->served[cls] < state->served[best] ||
+            (state->served[cls] == state->served[best] &&
+             view->head_ns[cls] < view->head_ns[best])) {
+            best = cls;
+        }
+    }
+    if (best != BOARDING_NONE) {
+        state->served[best] +=
+            view->size[best] * WFQ_SCALE / state->weight[best];
+    }
+    return best;
+}
+
+// --- Built-in policies, selected with --policy=NAME ---
+const BoardingPolicy BOARDING_POLICIES[] = {
+    {"alternate", pick_alternate},
+    {"fifo", pick_fifo},
+    {"trucks-first", pick_trucks_first},
+    {"longest-waiting", pick_longest_waiting},
+    {"wfq", pick_wfq},
+};
+const int BOARDING_POLICY_COUNT =
+    sizeof(BOARDING_POLICIES) / sizeof(BOARDING_POLICIES[0]);
+
+/**
+ * @brief Looks up a boarding policy by name
+ * @param name Name of the policy
+ * @return Index into BOARDING_POLICIES, or -1 if there is no such policy
+ */
+int boarding_policy_find(const char *name) {
+    for (int i = 0; i < BOARDING_POLICY_COUNT; i++) {
+        if (strcmp(name, BOARDING_POLICIES[i].name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Resets the state of the boarding policies
+ * @param state The state
+ * @param policy Index of the selected policy
+ * @param classes Vehicle classes with their sizes and WFQ weights
+ */
+void boarding_init(BoardingState *state, int policy,
+                   const ClassTable *classes) {
+    state->policy = policy;
+    state->next_class = 0;
+    for (int cls = 0; cls < MAX_VEHICLE_CLASSES; cls++) {
+        int used = cls < classes->count;
+        state->served[cls] = 0;
+        state->weight[cls] = used ? classes->classes[cls].weight : 1;
+        state->size[cls] = used ? classes->classes[cls].size : 0;
+    }
+}
+
+/**
+ * @brief Asks the selected policy for the next vehicle class
+ * @param state The state
+ * @param view The port the ferry is docked at
+ * @return ID of the class, BOARDING_NONE if nothing can board
+ */
+int boarding_pick(BoardingState *state, const BoardingView *view) {
+    return BOARDING_POLICIES[state->policy].pick(view, state);
+}
+
+/**
+ * @brief Stamps the arrival of a vehicle
+ * @param queue Queue of the vehicle class at its port
+ * @param arrived_ns Arrival time
+ *
+ * A full queue drops the stamp; until it drains, its head is treated as
+ * the fallback time given to arrival_queue_head().
+ */
+void arrival_queue_push(ArrivalQueue *queue, long long arrived_ns) {
+    if (queue->len == BOARDING_QUEUE_LEN) {
+        return;
+    }
+    queue->stamps[(queue->head + queue->len) % BOARDING_QUEUE_LEN] =
+        arrived_ns;
+    queue->len++;
+}
+
+/**
+ * @brief Removes the stamp of the oldest vehicle after it was called
+ * @param queue The queue
+ */
+void arrival_queue_pop(ArrivalQueue *queue) {
+    if (queue->len > 0) {
+        queue->head = (queue->head + 1) % BOARDING_QUEUE_LEN;
+        queue->len--;
+    }
+}
+
+/**
+ * @brief Returns the arrival time of the oldest vehicle
+ * @param queue The queue
+ * @param fallback Returned when the queue holds no stamp
+ * @return Arrival time in nanoseconds
+ */
+long long arrival_queue_head(const ArrivalQueue *queue, long long fallback) {
+    return queue->len > 0 ? queue->stamps[queue->head] : fallback;
+}
@@ -0,0 +1,116 @@
+#include "checker.h"
+
+/**
+ * @brief Publishes a logged action to the checker
+ * @param shared_data Pointer to the shared data, action_counter_sem held
+ * @param number Action number
+ * @param vehicle_type 'P', 'O' or 'N'
+ * @param id Vehicle id, 0 for the ferry
+ * @param action Action name as logged
+ * @param port Port of the action, -1 if none
+ */
+void publish_event(SharedData *shared_data, long long number,
+                   char vehicle_type, int id, const char *action, int port) {
+    Event event = {.number = number,
+                   .type = vehicle_type,
+                   .id = id,
+                   .action = event_action_find(action),
+                   .port = port};
+    event_ring_push(shared_data->events, &event);
+}
+
+/**
+ * @brief Prints the violation and the events leading to it
+ * @param checker The checker holding the violation
+ * @param window Last checked events, oldest at window[next % CHECK_WINDOW]
+ * @param count Events checked so far, the offending one included
+ */
+static void report_violation(const InvariantChecker *checker,
+                             const Event window[CHECK_WINDOW],
+                             long long count) {
+    fprintf(stderr, "[ERROR] Invariant violated: %s\n", checker->error);
+    long long first = count > CHECK_WINDOW ? count - CHECK_WINDOW : 0;
+    fprintf(stderr, "Last %lld events:\n", count - first);
+    for (long long i = first; i < count; i++) {
+        char line[EVENT_LINE_LEN];
+        format_event(&window[i % CHECK_WINDOW], line, sizeof(line));
+        fprintf(stderr, "  %s\n", line);
+    }
+}
+
+/**
+ * @brief Stops the run after a violation
+ * @param shared_data Pointer to the shared data
+ */
+static void fail_run(SharedData *shared_data) {
+    shared_data->check_failed = 1;
+    abort_run(shared_data);
+}
+
+/**
+ * @brief Main function for the checker process
+ * @param shared_data Pointer to the shared data
+ * @param cfg Configuration structure
+ *
+ * Feeds every published event to the invariant checker in counter order.
+ * Memory stays constant per vehicle and the window of the last events is
+ * kept locally, since the writer reuses consumed slots.
+ */
+void checker_process(SharedData *shared_data, Config cfg) {
+    InvariantChecker checker;
+    if (invariant_init(&checker, &cfg.classes, cfg.capacity_of_ferry,
+                       cfg.crossings) != EXIT_SUCCESS) {
+        fprintf(stderr, "[ERROR] Checker is out of memory\n");
+        fail_run(shared_data);
+        return;
+    }
+    EventRing *ring = shared_data->events;
+    struct timespec tick = {0, CHECK_TICK_MS * NS_PER_MS};
+    Event window[CHECK_WINDOW];
+    long long count = 0;
+    int result = EXIT_SUCCESS;
+
+    while (result == EXIT_SUCCESS && !checker.ferry_finished) {
+        long long written = event_ring_wait(ring, &tick);
+        if (written == count) {
+            // A killed run publishes nothing more
+            if (__atomic_load_n(&shared_data->aborted, __ATOMIC_ACQUIRE)) {
+                break;
+            }
+            continue;
+        }
+        for (; count < written && result == EXIT_SUCCESS; count++) {
+            window[count % CHECK_WINDOW] = ring->slots[count % EVENT_RING_LEN];
+            result = invariant_feed(&checker, &window[count % CHECK_WINDOW]);
+        }
+        event_ring_consume(ring, count);
+    }
+    if (result == EXIT_SUCCESS &&
+        !__atomic_load_n(&shared_data->aborted, __ATOMIC_ACQUIRE)) {
+        result = invariant_finish(&checker);
+    }
+    if (result != EXIT_SUCCESS) {
+        report_violation(&checker, window, count);
+        fail_run(shared_data);
+    }
+    invariant_destroy(&checker);
+}
+
+/**
+ * @brief Creates the checker process
+ * @param shared_data Pointer to the shared data
+ * @param cfg Configuration structure
+ * @return PID of the checker process
+ */
+pid_t create_checker_process(SharedData *shared_data, Config cfg) {
+    pid_t checker_pid = fork();
+    if (checker_pid == 0) {
+        apply_helper_placement(cfg);
+        checker_process(shared_data, cfg);
+        _exit(EXIT_SUCCESS);
+    } else if (checker_pid < 0) {
+        fprintf(stderr, "[ERROR] fork failed\n");
+        exit(EXIT_FAILURE);
+    }
+    return checker_pid;
+}
@@ -0,0 +1,326 @@
+#include "main.h"
+#include "port_server.h"
+#include "service.h"
+#include "watchdog.h"
+
+/**
+ * @brief Helper function to parse and validate an argument
+ * @param value_str The value that has to be parsed
+ * @param min Minimum allowed value
+ * @param max Maximum allowed value
+ * @param arg_name Name of the argument for error messages
+ * @param result Pointer to store the parsed value
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ */
+int parse_uint(const char *value_str, int min, int max, const char *arg_name,
+               int *result) {
+    char *end;
+    int value = strtoul(value_str, &end, PARSE_BASE_DECIMAL);
+
+    // Check for parsing errors or out-of-range values
+    if (*end != '\0' || value < min || value > max) {
+        fprintf(stderr,
+                "[ERROR] Invalid or out-of-range value for %s: %s "
+                "(allowed range: %d-%d)\n",
+                arg_name, value_str, min, max);
+        return EXIT_FAILURE;
+    }
+
+    *result = value;
+    return EXIT_SUCCESS;
+}
+
+// --- Optional settings, given as "--name=value" or "--name" for 1 ---
+static const IntOption INT_OPTIONS[] = {
+    {"stats", offsetof(Config, stats), 0, 1},
+    {"spin-max", offsetof(Config, spin_max), 0, ADAPTIVE_SPIN_MAX},
+    {"ferry-cpu", offsetof(Config, ferry_cpu), 0, CPU_SETSIZE - 1},
+    {"ferry-fifo", offsetof(Config, ferry_fifo), 0, MAX_FIFO_PRIORITY},
+    {"ferry-nice-boost", offsetof(Config, ferry_nice_boost), 0,
+     MAX_NICE_BOOST},
+    {"numa-node", offsetof(Config, numa_node), 0, MAX_NUMA_NODE},
+    {"watchdog-ms", offsetof(Config, watchdog_ms), 0, MAX_WATCHDOG_MS},
+    {"watchdog-events", offsetof(Config, watchdog_events), 0, EVENT_HISTORY},
+    {"seed", offsetof(Config, seed), 0, RAND_MAX},
+    {"fuzz-seed", offsetof(Config, fuzz_seed), 0, RAND_MAX},
+    {"fuzz-delay-us", offsetof(Config, fuzz_delay_us), 0, MAX_FUZZ_DELAY_US},
+    {"report-ms", offsetof(Config, report_ms), 0, MAX_REPORT_MS},
+    {"live-ms", offsetof(Config, live_ms), 1, MAX_LIVE_INTERVAL_MS},
+    {"wfq-car-weight", offsetof(Config, wfq_car_weight), 1, MAX_WFQ_WEIGHT},
+    {"wfq-truck-weight", offsetof(Config, wfq_truck_weight), 1,
+     MAX_WFQ_WEIGHT},
+    {"hold-us", offsetof(Config, hold_us), 0, MAX_HOLD_US},
+    {"min-fill", offsetof(Config, min_fill), 0, 100},
+    {"idle-park", offsetof(Config, idle_park), 0, 1},
+    {"dispatch", offsetof(Config, dispatch), 0, 1},
+    {"deck-lanes", offsetof(Config, deck_lanes), 1, MAX_DECK_LANES},
+    {"check", offsetof(Config, check), 0, 1},
+    {"queue-limit", offsetof(Config, queue_limit), 0, MAX_QUEUE_LIMIT},
+    {"timer-slack-ns", offsetof(Config, timer_slack_ns), 0,
+     MAX_TIMER_SLACK_NS},
+    {"round-trips", offsetof(Config, round_trips), 0, MAX_ROUND_TRIPS},
+    {"dwell-us", offsetof(Config, dwell_us), 0, MAX_DWELL_US},
+};
+
+static const StrOption STR_OPTIONS[] = {
+    {"vehicle-cpus", offsetof(Config, vehicle_cpus_list)},
+    {"stream", offsetof(Config, stream_path)},
+    {"live-stats", offsetof(Config, live_stats_name)},
+    {"trip-log", offsetof(Config, trip_log_path)},
+    {"trace", offsetof(Config, trace_path)},
+    {"policy", offsetof(Config, policy_name)},
+    {"depart", offsetof(Config, depart_name)},
+    {"unload", offsetof(Config, unload_name)},
+    {"ports", offsetof(Config, ports_name)},
+    {"scenario", offsetof(Config, scenario_path)},
+    {"classes", offsetof(Config, classes_spec)},
+};
+
+/**
+ * @brief Helper function to parse one optional "--name=value" argument
+ * @param arg The argument including the "--" prefix
+ * @param cfg Configuration structure
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ */
+int parse_option(const char *arg, Config *cfg) {
+    const char *name = arg + strlen(OPTION_PREFIX);
+    const char *value = strchr(name, '=');
+    size_t name_len = value ? (size_t)(value - name) : strlen(name);
+
+    for (size_t i = 0; i < sizeof(INT_OPTIONS) / sizeof(INT_OPTIONS[0]);
+         i++) {
+        const IntOption *opt = &INT_OPTIONS[i];
+        if (strlen(opt->name) != name_len ||
+            strncmp(opt->name, name, name_len) != 0) {
+            continue;
+        }
+        int *field = (int *)((char *)cfg + opt->offset);
+        // A bare flag means "enabled"
+        if (value == NULL) {
+            return parse_uint("1", opt->min, opt->max, opt->name, field);
+        }
+        return parse_uint(value + 1, opt->min, opt->max, opt->name, field);
+    }
+
+    for (size_t i = 0; i < sizeof(STR_OPTIONS) / sizeof(STR_OPTIONS[0]);
+         i++) {
+        const StrOption *opt = &STR_OPTIONS[i];
+        if (strlen(opt->name) != name_len ||
+            strncmp(opt->name, name, name_len) != 0) {
+            continue;
+        }
+        if (value == NULL || value[1] == '\0') {
+            fprintf(stderr, "[ERROR] Option %s needs a value\n", arg);
+            return EXIT_FAILURE;
+        }
+        *(const char **)((char *)cfg + opt->offset) = value + 1;
+        return EXIT_SUCCESS;
+    }
+
+    fprintf(stderr, "[ERROR] Unknown option %s\n", arg);
+    return EXIT_FAILURE;
+}
+
+/**
+ * @brief Sets every optional setting to its default
+ * @param cfg Configuration structure
+ *
+ * The positional settings are left alone, embedders set them directly.
+ */
+void config_defaults(Config *cfg) {
+    cfg->stats = 0;
+    cfg->spin_max = ADAPTIVE_SPIN_MAX;
+    cfg->ferry_cpu = PLACEMENT_UNSET;
+    cfg->ferry_fifo = 0;
+    cfg->ferry_nice_boost = 0;
+    cfg->numa_node = PLACEMENT_UNSET;
+    cfg->vehicle_cpus_list = NULL;
+    cfg->watchdog_ms = 0;
+    cfg->watchdog_events = WATCHDOG_DEFAULT_EVENTS;
+    cfg->seed = 0;
+    cfg->fuzz_seed = 0;
+    cfg->fuzz_delay_us = FUZZ_DEFAULT_DELAY_US;
+    cfg->report_ms = 0;
+    cfg->stream_path = NULL;
+    cfg->live_ms = LIVE_DEFAULT_INTERVAL_MS;
+    cfg->live_stats_name = NULL;
+    cfg->trip_log_path = NULL;
+    cfg->trace_path = NULL;
+    cfg->policy_name = DEFAULT_BOARDING_POLICY;
+    cfg->wfq_car_weight = 1;
+    cfg->wfq_truck_weight = 1;
+    cfg->depart_name = DEFAULT_DEPARTURE_RULE;
+    cfg->hold_us = DEFAULT_HOLD_US;
+    cfg->unload_name = DEFAULT_UNLOAD_ORDER;
+    cfg->deck_lanes = 1;
+    cfg->min_fill = 100;
+    cfg->idle_park = 1;
+    cfg->dispatch = 1;
+    cfg->check = 0;
+    cfg->queue_limit = 0;
+    cfg->timer_slack_ns = 0;
+    cfg->round_trips = 0;
+    cfg->dwell_us = 0;
+    cfg->crossings = 1;
+    cfg->ports_name = DEFAULT_PORT_LINK;
+    cfg->port_link = PORT_LINK_SHARED;
+    cfg->scenario_path = NULL;
+    cfg->scenario.count = 0;
+    cfg->classes_spec = NULL;
+    class_table_init(&cfg->classes);
+    cfg->boarding_policy = boarding_policy_find(DEFAULT_BOARDING_POLICY);
+    cfg->departure_rule = departure_rule_find(DEFAULT_DEPARTURE_RULE);
+    cfg->unload_order = unload_order_find(DEFAULT_UNLOAD_ORDER);
+    cfg->log = sink_none();
+}
+
+/**
+ * @brief Builds the vehicle class table of the run
+ * @param cfg Configuration structure, counts already final
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ *
+ * Cars and trucks come first, so their vehicle indexes and random streams
+ * are the same with and without added classes.
+ */
+static int config_classes(Config *cfg) {
+    class_table_builtin(&cfg->classes, cfg->num_cars, cfg->num_trucks);
+    VehicleClass *car = &cfg->classes.classes[CLASS_CAR];
+    VehicleClass *truck = &cfg->classes.classes[CLASS_TRUCK];
+    car->max_arrival_us = cfg->max_vehicle_arrival_us;
+    truck->max_arrival_us = cfg->max_vehicle_arrival_us;
+    car->weight = cfg->wfq_car_weight;
+    truck->weight = cfg->wfq_truck_weight;
+    if (cfg->classes_spec != NULL &&
+        class_table_parse(&cfg->classes, cfg->classes_spec,
+                          cfg->max_vehicle_arrival_us)) {
+        return EXIT_FAILURE;
+    }
+    // A vehicle that never fits would wait forever
+    for (int cls = 0; cls < cfg->classes.count; cls++) {
+        const VehicleClass *vehicle_class = &cfg->classes.classes[cls];
+        if (vehicle_class->size > cfg->capacity_of_ferry) {
+            fprintf(stderr, "[ERROR] A %s does not fit on the ferry\n",
+                    vehicle_class->name);
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Resolves the named settings and checks settings that depend on
+ * each other
+ * @param cfg Configuration structure
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ */
+int config_validate(Config *cfg) {
+    if (cfg->vehicle_cpus_list != NULL &&
+        parse_cpu_list(cfg->vehicle_cpus_list, &cfg->vehicle_cpus)) {
+        return EXIT_FAILURE;
+    }
+    cfg->boarding_policy = boarding_policy_find(cfg->policy_name);
+    if (cfg->boarding_policy == -1) {
+        fprintf(stderr, "[ERROR] Unknown boarding policy %s\n",
+                cfg->policy_name);
+        return EXIT_FAILURE;
+    }
+    cfg->departure_rule = departure_rule_find(cfg->depart_name);
+    if (cfg->departure_rule == -1) {
+        fprintf(stderr, "[ERROR] Unknown departure rule %s\n",
+                cfg->depart_name);
+        return EXIT_FAILURE;
+    }
+    cfg->port_link = port_link_find(cfg->ports_name);
+    if (cfg->port_link == -1) {
+        fprintf(stderr, "[ERROR] Unknown port link %s\n", cfg->ports_name);
+        return EXIT_FAILURE;
+    }
+    cfg->unload_order = unload_order_find(cfg->unload_name);
+    if (cfg->unload_order == -1) {
+        fprintf(stderr, "[ERROR] Unknown unload order %s\n", cfg->unload_name);
+        return EXIT_FAILURE;
+    }
+    // A scenario fixes the batch, replacing the positional counts
+    if (cfg->scenario_path != NULL) {
+        if (scenario_load(cfg->scenario_path, &cfg->scenario)) {
+            return EXIT_FAILURE;
+        }
+        cfg->num_cars = cfg->scenario.cars;
+        cfg->num_trucks = cfg->scenario.trucks;
+    }
+    if (config_classes(cfg) != EXIT_SUCCESS) {
+        return EXIT_FAILURE;
+    }
+    // A round trip crosses there and back, so the vehicle ends where it began
+    cfg->crossings = cfg->round_trips > 0 ? 2 * cfg->round_trips : 1;
+    // The checker needs the number of vehicles up front
+    if (cfg->check && cfg->stream_path != NULL) {
+        fprintf(stderr, "[ERROR] check does not support an arrival stream\n");
+        return EXIT_FAILURE;
+    }
+    // Port servers size their queues by the classes and count the arrivals
+    if (cfg->port_link != PORT_LINK_SHARED && cfg->stream_path != NULL) {
+        fprintf(stderr, "[ERROR] Linked ports do not support an arrival "
+                        "stream\n");
+        return EXIT_FAILURE;
+    }
+    // A hold must not look like a stall
+    if (cfg->departure_rule != DEPART_IMMEDIATE && cfg->watchdog_ms > 0 &&
+        cfg->hold_us >= cfg->watchdog_ms * 1000) {
+        fprintf(stderr, "[ERROR] hold-us must be shorter than watchdog-ms\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Function to parse arguments
+ * @param argc Number of arguments
+ * @param argv Arguments list
+ * @param cfg Configuration structure
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ * 
+ * This function parses the command line arguments and checks their ranges.
+ * If any argument is invalid, it prints an error message and returns EXIT_FAILURE.
+ * Arguments starting with "--" are optional settings and may appear anywhere,
+ * the remaining ones are the positional arguments. Named settings and
+ * files such as the scenario are resolved by config_validate(), which
+ * ferry_sim_create() runs once.
+ */
+int parse_args(int argc, char const *argv[], Config *cfg) {
+    const char *args[EXPECTED_ARGS] = {argv[0]};
+    int count = 1;
+
+    config_defaults(cfg);
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], OPTION_PREFIX, strlen(OPTION_PREFIX)) == 0) {
+            if (parse_option(argv[i], cfg) != EXIT_SUCCESS) {
+                return EXIT_FAILURE;
+            }
+        } else if (count++ < EXPECTED_ARGS) {
+            args[count - 1] = argv[i];
+        }
+    }
+
+    if (count != EXPECTED_ARGS) {
+        fprintf(stderr, "[ERROR] Expected %d arguments, got %d\n",
+                EXPECTED_ARGS, count);
+        return EXIT_FAILURE;
+    }
+
+    // Parse and validate each argument
+    if (parse_uint(args[1], 0, MAX_NUM_TRUCKS, "num_trucks",
+                   &cfg->num_trucks) ||
+        parse_uint(args[2], 0, MAX_NUM_CARS, "num_cars", &cfg->num_cars) ||
+        parse_uint(args[3], MIN_CAPACITY_PARCEL, MAX_CAPACITY_PARCEL,
+                   "capacity_of_ferry", &cfg->capacity_of_ferry) ||
+        parse_uint(args[4], MIN_VEHICLE_ARRIVAL_US, MAX_VEHICLE_ARRIVAL_US,
+                   "max_vehicle_arrival_us", &cfg->max_vehicle_arrival_us) ||
+        parse_uint(args[5], MIN_FERRY_ARRIVAL_US, MAX_FERRY_ARRIVAL_US,
+                   "max_ferry_arrival_us", &cfg->max_ferry_arrival_us)) {
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
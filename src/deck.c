@@ -0,0 +1,87 @@
+#include "deck.h"
+
+#include "main.h"
+
+// --- Order names as given to --unload ---
+static const char *ORDER_NAMES[] = {
+    [UNLOAD_FIFO] = "fifo",
+    [UNLOAD_LIFO] = "lifo",
+};
+
+/**
+ * @brief Looks up an unload order by name
+ * @param name Name of the order
+ * @return The order, or -1 if there is no such order
+ */
+int unload_order_find(const char *name) {
+    for (size_t i = 0; i < sizeof(ORDER_NAMES) / sizeof(ORDER_NAMES[0]);
+         i++) {
+        if (strcmp(name, ORDER_NAMES[i]) == 0) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Returns the name of an unload order
+ */
+const char *unload_order_name(int order) {
+    return ORDER_NAMES[order];
+}
+
+/**
+ * @brief Initializes an empty deck
+ * @param deck The deck
+ * @param order The unload order
+ * @param lanes Lanes the slots are spread over
+ */
+void deck_init(Deck *deck, int order, int lanes) {
+    deck->order = order;
+    deck->lanes = lanes;
+    deck_clear(deck);
+}
+
+/**
+ * @brief Parks a boarding vehicle in the next free slot
+ * @param deck The deck, lock_mutex held
+ * @param entry Vehicle table entry of the vehicle
+ * @return The slot
+ */
+int deck_park(Deck *deck, int entry) {
+    int slot = deck->count++;
+    deck->entry[slot] = entry;
+    deck->next[slot] = DECK_NONE;
+    return slot;
+}
+
+/**
+ * @brief Links the occupied slots in the order they leave
+ * @param deck The deck, lock_mutex held
+ * @return The slot leaving first, or DECK_NONE on an empty deck
+ */
+int deck_plan_unload(Deck *deck) {
+    int first = DECK_NONE;
+    int *link = &first;
+    int positions = (deck->count + deck->lanes - 1) / deck->lanes;
+    for (int i = 0; i < positions; i++) {
+        int position = deck->order == UNLOAD_LIFO ? positions - 1 - i : i;
+        for (int lane = 0; lane < deck->lanes; lane++) {
+            int slot = position * deck->lanes + lane;
+            if (slot < deck->count) {
+                *link = slot;
+                link = &deck->next[slot];
+            }
+        }
+    }
+    *link = DECK_NONE;
+    return first;
+}
+
+/**
+ * @brief Empties the deck after unloading
+ * @param deck The deck, lock_mutex held
+ */
+void deck_clear(Deck *deck) {
+    deck->count = 0;
+}
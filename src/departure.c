@@ -0,0 +1,76 @@
+#include "departure.h"
+
+#include "main.h"
+
+// --- Rule names as given to --depart ---
+static const char *RULE_NAMES[] = {
+    [DEPART_IMMEDIATE] = "immediate",
+    [DEPART_HOLD] = "hold",
+    [DEPART_EWMA] = "ewma",
+};
+
+/**
+ * @brief Looks up a departure rule by name
+ * @param name Name of the rule
+ * @return The rule, or -1 if there is no such rule
+ */
+int departure_rule_find(const char *name) {
+    for (size_t i = 0; i < sizeof(RULE_NAMES) / sizeof(RULE_NAMES[0]); i++) {
+        if (strcmp(name, RULE_NAMES[i]) == 0) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Returns the name of a departure rule
+ */
+const char *departure_rule_name(int rule) {
+    return RULE_NAMES[rule];
+}
+
+/**
+ * @brief Decides whether the ferry keeps holding at the port
+ * @param rule The departure rule
+ * @param min_fill Fill in percent at which the ferry leaves early
+ * @param view State of the deck and the port
+ * @return 1 to keep holding, 0 to leave
+ *
+ * Nothing is worth waiting for once the deck has no room for the smallest
+ * vehicle, the fill target is met or no vehicle is left to arrive.
+ */
+int departure_should_hold(int rule, int min_fill, const DepartureView *view) {
+    if (rule == DEPART_IMMEDIATE || !view->arrivals_possible ||
+        view->capacity - view->deck_units < view->min_size ||
+        view->deck_units * 100 >= min_fill * view->capacity ||
+        view->now >= view->deadline) {
+        return 0;
+    }
+    if (rule == DEPART_EWMA) {
+        // No estimate before the second arrival
+        return view->arrival_gap_ns > 0 &&
+               view->now + view->arrival_gap_ns <= view->deadline;
+    }
+    return 1;
+}
+
+/**
+ * @brief Folds a new arrival into the smoothed inter-arrival gap
+ * @param gap_ns Current smoothed gap, 0 if unknown
+ * @param last_ns Previous arrival at the port, 0 if none
+ * @param arrived_ns The new arrival
+ * @return The new smoothed gap
+ */
+long long arrival_gap_update(long long gap_ns, long long last_ns,
+                             long long arrived_ns) {
+    if (last_ns == 0) {
+        return gap_ns;
+    }
+    // Arrival stamps are taken before the lock, so they may be reordered
+    long long gap = arrived_ns > last_ns ? arrived_ns - last_ns : 0;
+    if (gap_ns == 0) {
+        return gap;
+    }
+    return gap_ns + (gap - gap_ns) / ARRIVAL_EWMA_WEIGHT;
+}
@@ -0,0 +1,127 @@
+#include "dispatcher.h"
+
+/**
+ * @brief Draws the arrival schedule of the batch vehicles
+ * @param cfg Configuration structure
+ * @return The sorted schedule, or NULL on failure
+ *
+ * Every vehicle gets the port and arrival delay it used to draw itself,
+ * from the same per-vehicle stream, so a seeded run keeps its schedule.
+ * A scenario draws the cars and trucks from one stream instead.
+ */
+ArrivalSchedule *schedule_build(Config cfg) {
+    ArrivalSchedule *schedule = schedule_create(cfg.classes.vehicles);
+    if (schedule == NULL) {
+        return NULL;
+    }
+    schedule->dispatched = cfg.dispatch;
+    // A local stream, the caller's rand() state stays untouched
+    unsigned int state = cfg.seed > 0 ? cfg.seed : getpid();
+    int drawn = 0;
+    if (cfg.scenario.count > 0) {
+        scenario_draw(&cfg.scenario, schedule->due_ns, schedule->port,
+                      &state);
+        drawn = cfg.scenario.cars + cfg.scenario.trucks;
+    }
+    for (int vehicle = 0; vehicle < schedule->count; vehicle++) {
+        schedule->vehicle[vehicle] = vehicle;
+        if (vehicle < drawn) {
+            continue;
+        }
+        int id;
+        int cls = class_of_vehicle(&cfg.classes, vehicle, &id);
+        if (cfg.seed > 0) {
+            state = stream_seed(cfg.seed, process_stream(cls, id));
+        }
+        schedule->port[vehicle] = rand_range_r(&state, 0, 1);
+        schedule->due_ns[vehicle] =
+            rand_range_r(&state, 0, cfg.classes.classes[cls].max_arrival_us) *
+            NS_PER_US;
+    }
+    if (schedule_sort(schedule) != EXIT_SUCCESS) {
+        schedule_destroy(schedule);
+        return NULL;
+    }
+    return schedule;
+}
+
+/**
+ * @brief Holds a scheduled vehicle back until its arrival
+ * @param shared_data Pointer to the shared data
+ * @param cfg Configuration structure
+ * @param slot Slot of the vehicle
+ *
+ * With the dispatcher the vehicle sleeps until its slot is released,
+ * otherwise it sleeps until the due time of the slot by itself.
+ */
+void schedule_await(SharedData *shared_data, Config cfg, int slot) {
+    if (cfg.dispatch) {
+        schedule_wait(shared_data->schedule, slot);
+    } else {
+        long long late = sleep_until(shared_data->start_ns +
+                                     shared_data->schedule->due_ns[slot]);
+        histogram_record(&shared_data->overshoot[SLEEP_ARRIVAL], late);
+    }
+}
+
+/**
+ * @brief Main function for the dispatcher process
+ * @param shared_data Pointer to the shared data
+ *
+ * Walks the sorted schedule and releases every slot that is due, sleeping
+ * once per distinct deadline. Only the dispatcher writes the counters.
+ */
+void dispatcher_process(SharedData *shared_data) {
+    ArrivalSchedule *schedule = shared_data->schedule;
+    for (int slot = 0; slot < schedule->count && !run_over(shared_data);
+         slot++) {
+        long long due = shared_data->start_ns + schedule->due_ns[slot];
+        long long now = now_ns();
+        if (now < due) {
+            sleep_until(due);
+            schedule->timers++;
+            now = now_ns();
+        }
+        schedule_release(schedule, slot);
+        schedule->late_ns_total += now - due;
+        if (now - due > schedule->late_ns_max) {
+            schedule->late_ns_max = now - due;
+        }
+    }
+}
+
+/**
+ * @brief Creates the dispatcher process
+ * @param shared_data Pointer to the shared data
+ * @param cfg Configuration structure
+ * @return PID of the dispatcher process
+ */
+pid_t create_dispatcher_process(SharedData *shared_data, Config cfg) {
+    pid_t dispatcher_pid = fork();
+    if (dispatcher_pid == 0) {
+        apply_helper_placement(cfg);
+        dispatcher_process(shared_data);
+        _exit(EXIT_SUCCESS);
+    } else if (dispatcher_pid < 0) {
+        fprintf(stderr, "[ERROR] fork failed\n");
+        exit(EXIT_FAILURE);
+    }
+    return dispatcher_pid;
+}
+
+/**
+ * @brief Prints how closely the dispatcher kept the schedule
+ * @param shared_data Pointer to the shared data
+ * @param out Output stream
+ */
+void print_dispatch_stats(SharedData *shared_data, FILE *out) {
+    const ArrivalSchedule *schedule = shared_data->schedule;
+    if (schedule == NULL || !schedule->dispatched) {
+        return;
+    }
+    fprintf(out, "Dispatcher: %d arrivals on %lld timers, "
+                 "lateness mean %.1f us, max %.1f us\n",
+            schedule->count, schedule->timers,
+            (double)schedule->late_ns_total / schedule->count / NS_PER_US,
+            (double)schedule->late_ns_max / NS_PER_US);
+}
@@ -0,0 +1,95 @@
+#include "event_ring.h"
+
+#include <stdio.h>     // fprintf
+#include <sys/mman.h>  // mmap
+
+#include "adaptive_wait.h"
+
+/**
+ * @brief Maps an empty ring in shared memory
+ * @return The ring, or NULL on failure
+ */
+EventRing *event_ring_create(void) {
+    EventRing *ring = mmap(NULL, sizeof(EventRing), PROT_READ | PROT_WRITE,
+                           MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (ring == MAP_FAILED) {
+        fprintf(stderr, "[ERROR] mmap failed for the event ring\n");
+        return NULL;
+    }
+    return ring;
+}
+
+/**
+ * @brief Publishes an event, waiting while the ring is full
+ * @param ring The ring
+ * @param event The event
+ *
+ * Callers serialize the writes, see print_action().
+ */
+void event_ring_push(EventRing *ring, const Event *event) {
+    long long written = ring->written;
+    while (written - __atomic_load_n(&ring->read, __ATOMIC_ACQUIRE) ==
+           EVENT_RING_LEN) {
+        // Take the sequence before the recheck, so a consume in between
+        // makes the futex wait return at once
+        int seq = __atomic_load_n(&ring->read_seq, __ATOMIC_SEQ_CST);
+        __atomic_store_n(&ring->writer_waiting, 1, __ATOMIC_SEQ_CST);
+        if (written - __atomic_load_n(&ring->read, __ATOMIC_SEQ_CST) ==
+            EVENT_RING_LEN) {
+            futex_wait(&ring->read_seq, seq, NULL);
+        }
+        __atomic_store_n(&ring->writer_waiting, 0, __ATOMIC_SEQ_CST);
+    }
+    ring->slots[written % EVENT_RING_LEN] = *event;
+    __atomic_store_n(&ring->written, written + 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&ring->reader_waiting, __ATOMIC_SEQ_CST)) {
+        __atomic_add_fetch(&ring->write_seq, 1, __ATOMIC_SEQ_CST);
+        futex_wake(&ring->write_seq, 1);
+    }
+}
+
+/**
+ * @brief Waits until the ring holds unconsumed events
+ * @param ring The ring
+ * @param timeout Longest wait, NULL for none
+ * @return Number of events published so far; equal to ring->read if the
+ * wait timed out
+ */
+long long event_ring_wait(EventRing *ring, const struct timespec *timeout) {
+    long long written = __atomic_load_n(&ring->written, __ATOMIC_ACQUIRE);
+    if (written != ring->read) {
+        return written;
+    }
+    int seq = __atomic_load_n(&ring->write_seq, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&ring->reader_waiting, 1, __ATOMIC_SEQ_CST);
+    written = __atomic_load_n(&ring->written, __ATOMIC_SEQ_CST);
+    if (written == ring->read) {
+        futex_wait(&ring->write_seq, seq, timeout);
+        written = __atomic_load_n(&ring->written, __ATOMIC_SEQ_CST);
+    }
+    __atomic_store_n(&ring->reader_waiting, 0, __ATOMIC_SEQ_CST);
+    return written;
+}
+
+/**
+ * @brief Hands the slots of consumed events back to the writer
+ * @param ring The ring
+ * @param upto Number of events consumed so far
+ */
+void event_ring_consume(EventRing *ring, long long upto) {
+    __atomic_store_n(&ring->read, upto, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&ring->writer_waiting, __ATOMIC_SEQ_CST)) {
+        __atomic_add_fetch(&ring->read_seq, 1, __ATOMIC_SEQ_CST);
+        futex_wake(&ring->read_seq, 1);
+    }
+}
+
+/**
+ * @brief Unmaps the ring
+ * @param ring The ring, may be NULL
+ */
+void event_ring_destroy(EventRing *ring) {
+    if (ring != NULL) {
+        munmap(ring, sizeof(EventRing));
+    }
+}
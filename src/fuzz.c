@@ -0,0 +1,69 @@
+#include "fuzz.h"
+
+#include <sched.h>   // sched_yield
+#include <unistd.h>  // usleep
+
+int fuzz_active = 0;
+
+// Per-process generator state
+static unsigned long long fuzz_state = 0;
+static int fuzz_max_delay_us = 0;
+
+/**
+ * @brief Advances the per-process xorshift generator
+ * @return Next pseudo-random value
+ */
+static unsigned long long fuzz_next(void) {
+    fuzz_state ^= fuzz_state << 13;
+    fuzz_state ^= fuzz_state >> 7;
+    fuzz_state ^= fuzz_state << 17;
+    return fuzz_state;
+}
+
+/**
+ * @brief Enables schedule fuzzing in the calling process
+ * @param seed Run seed, 0 leaves fuzzing off
+ * @param stream Stable identity of the process within the run
+ * @param max_delay_us Upper bound of an injected delay
+ *
+ * Deriving the generator from the seed and a stable stream instead of the
+ * PID makes each process draw the same perturbations when a seed is re-run.
+ */
+void fuzz_init(unsigned int seed, unsigned int stream, int max_delay_us) {
+    if (seed == 0) {
+        return;
+    }
+    fuzz_state = ((unsigned long long)seed << 32 | stream) *
+                     0x9E3779B97F4A7C15ULL +
+                 1;
+    fuzz_max_delay_us = max_delay_us;
+    fuzz_active = 1;
+}
+
+/**
+ * @brief Perturbs the schedule at an injection point
+ *
+ * Half of the points pass through, most of the rest yield the CPU and one
+ * in sixteen sleeps for a random delay.
+ */
+void fuzz_perturb(void) {
+    unsigned long long roll = fuzz_next();
+    switch (roll % 16) {
+        case 0:
+            usleep(fuzz_max_delay_us > 0
+                       ? (roll >> 8) % (unsigned)(fuzz_max_delay_us + 1)
+                       : 0);
+            break;
+        case 1:
+        case 2:
+        case 3:
+        case 4:
+        case 5:
+        case 6:
+        case 7:
+            sched_yield();
+            break;
+        default:
+            break;
+    }
+}
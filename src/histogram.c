@@ -0,0 +1,116 @@
+#include "histogram.h"
+
+#include <string.h>  // memset
+
+#include "timing.h"
+
+/**
+ * @brief Maps a value to its bucket
+ * @param value Non-negative value
+ * @return Bucket index
+ */
+static int bucket_of(long long value) {
+    if (value < HIST_SUB_BUCKETS) {
+        return value < 0 ? 0 : (int)value;
+    }
+    int magnitude = 63 - __builtin_clzll((unsigned long long)value);
+    int top = (int)(value >> (magnitude - HIST_SUB_BITS));
+    int index =
+        (magnitude - HIST_SUB_BITS + 1) * HIST_SUB_BUCKETS + top - HIST_SUB_BUCKETS;
+    return index < HIST_BUCKETS ? index : HIST_BUCKETS - 1;
+}
+
+/**
+ * @brief Returns the middle of the value range of a bucket
+ * @param index Bucket index
+ */
+static long long bucket_value(int index) {
+    if (index < HIST_SUB_BUCKETS) {
+        return index;
+    }
+    int magnitude = index / HIST_SUB_BUCKETS + HIST_SUB_BITS - 1;
+    long long top = index % HIST_SUB_BUCKETS + HIST_SUB_BUCKETS;
+    int shift = magnitude - HIST_SUB_BITS;
+    return (top << shift) + ((1LL << shift) >> 1);
+}
+
+/**
+ * @brief Clears a histogram
+ * @param hist The histogram
+ */
+void histogram_init(Histogram *hist) {
+    memset(hist, 0, sizeof(*hist));
+}
+
+/**
+ * @brief Records one value
+ * @param hist The histogram
+ * @param value Value to record, e.g. a latency in nanoseconds
+ */
+void histogram_record(Histogram *hist, long long value) {
+    __atomic_add_fetch(&hist->counts[bucket_of(value)], 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&hist->total, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&hist->sum, value, __ATOMIC_RELAXED);
+    long long max = __atomic_load_n(&hist->max, __ATOMIC_RELAXED);
+    while (value > max &&
+           !__atomic_compare_exchange_n(&hist->max, &max, value, 1,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+/**
+ * @brief Adds all values of one histogram to another
+ * @param dst Histogram to add to
+ * @param src Histogram to add
+ */
+void histogram_merge(Histogram *dst, const Histogram *src) {
+    for (int i = 0; i < HIST_BUCKETS; i++) {
+        dst->counts[i] += src->counts[i];
+    }
+    dst->total += src->total;
+    dst->sum += src->sum;
+    if (src->max > dst->max) {
+        dst->max = src->max;
+    }
+}
+
+/**
+ * @brief Returns the value at a percentile
+ * @param hist The histogram
+ * @param percentile Percentile between 0 and 100
+ * @return Approximate value, never more than the recorded maximum
+ */
+long long histogram_percentile(const Histogram *hist, double percentile) {
+    unsigned long long rank =
+        (unsigned long long)(hist->total * percentile / 100.0 + 0.5);
+    unsigned long long seen = 0;
+    if (rank == 0) {
+        rank = 1;
+    }
+    for (int i = 0; i < HIST_BUCKETS; i++) {
+        seen += hist->counts[i];
+        if (seen >= rank) {
+            long long value = bucket_value(i);
+            return value < hist->max ? value : hist->max;
+        }
+    }
+    return hist->max;
+}
+
+/**
+ * @brief Prints count, mean, p50, p99, p99.9 and max in milliseconds
+ * @param hist The histogram
+ * @param name Row label
+ * @param out Output stream
+ */
+void histogram_print(const Histogram *hist, const char *name, FILE *out) {
+    if (hist->total == 0) {
+        fprintf(out, "  %-28s %8d\n", name, 0);
+        return;
+    }
+    double ms = NS_PER_MS;
+    fprintf(out, "  %-28s %8llu %9.3f %9.3f %9.3f %9.3f %9.3f\n", name,
+            hist->total, hist->sum / ms / hist->total,
+            histogram_percentile(hist, 50.0) / ms,
+            histogram_percentile(hist, 99.0) / ms,
+            histogram_percentile(hist, 99.9) / ms, hist->max / ms);
+}
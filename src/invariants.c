@@ -0,0 +1,337 @@
+#include "invariants.h"
+
+#include "main.h"
+
+// --- Action names as they appear in the log ---
+static const char *ACTION_NAMES[] = {
+    [EVENT_STARTED] = "started",     [EVENT_ARRIVED] = "arrived to",
+    [EVENT_BOARDING] = "boarding",   [EVENT_LEAVING_IN] = "leaving in",
+    [EVENT_LEAVING] = "leaving",     [EVENT_FINISH] = "finish",
+};
+
+/**
+ * @brief Looks up an action by the name print_action() logs
+ * @param name The action name
+ * @return The action, or EVENT_ACTION_INVALID if there is no such action
+ */
+EventAction event_action_find(const char *name) {
+    for (size_t i = 0; i < sizeof(ACTION_NAMES) / sizeof(ACTION_NAMES[0]);
+         i++) {
+        if (strcmp(name, ACTION_NAMES[i]) == 0) {
+            return (EventAction)i;
+        }
+    }
+    return EVENT_ACTION_INVALID;
+}
+
+/**
+ * @brief Parses one log line such as "12: O 3: arrived to 1"
+ * @param line The line, with or without the trailing newline
+ * @param event Parsed event
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ */
+int parse_event_line(const char *line, Event *event) {
+    char action[32];
+    int consumed = 0;
+
+    if (sscanf(line, "%lld: %c%n", &event->number, &event->type, &consumed) !=
+        2) {
+        return EXIT_FAILURE;
+    }
+    line += consumed;
+    event->id = 0;
+    if (*line == ' ') {
+        if (sscanf(line, " %d%n", &event->id, &consumed) != 1) {
+            return EXIT_FAILURE;
+        }
+        line += consumed;
+    }
+    if (sscanf(line, ": %31[a-z ]%n", action, &consumed) != 1) {
+        return EXIT_FAILURE;
+    }
+    line += consumed;
+
+    // The port, if any, follows the action name
+    event->port = -1;
+    if (sscanf(line, "%d", &event->port) != 1) {
+        event->port = -1;
+    }
+    size_t len = strlen(action);
+    while (len > 0 && action[len - 1] == ' ') {
+        action[--len] = '\0';
+    }
+    event->action = event_action_find(action);
+    return event->action == EVENT_ACTION_INVALID ? EXIT_FAILURE
+                                                 : EXIT_SUCCESS;
+}
+
+/**
+ * @brief Formats an event the way print_action() logs it
+ * @param event The event
+ * @param buf Output buffer
+ * @param size Size of the output buffer
+ * @return Number of characters written
+ */
+int format_event(const Event *event, char *buf, size_t size) {
+    int len = snprintf(buf, size, "%lld: %c", event->number, event->type);
+    if (event->id != 0) {
+        len += snprintf(buf + len, size - len, " %d", event->id);
+    }
+    len += snprintf(buf + len, size - len, ": %s",
+                    ACTION_NAMES[event->action]);
+    if (event->port != -1) {
+        len += snprintf(buf + len, size - len, " %d", event->port);
+    }
+    return len;
+}
+
+/**
+ * @brief Initializes a checker for a run
+ * @param checker The checker
+ * @param classes Vehicles of each class in the run
+ * @param capacity Ferry capacity in units
+ * @param crossings Crossings every vehicle makes, 1 without round trips
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ */
+int invariant_init(InvariantChecker *checker, const ClassTable *classes,
+                   int capacity, int crossings) {
+    int vehicles = classes->vehicles;
+    memset(checker, 0, sizeof(*checker));
+    checker->capacity = capacity;
+    checker->crossings = crossings;
+    checker->classes = *classes;
+    checker->next_number = 1;
+    checker->ferry_port = -1;
+    checker->state = calloc(vehicles + 1, sizeof(*checker->state));
+    checker->port = calloc(vehicles + 1, sizeof(*checker->port));
+    checker->boarded_stop = calloc(vehicles + 1, sizeof(*checker->boarded_stop));
+    checker->crossed = calloc(vehicles + 1, sizeof(*checker->crossed));
+    if (!checker->state || !checker->port || !checker->boarded_stop ||
+        !checker->crossed) {
+        invariant_destroy(checker);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Records the first violation
+ * @return EXIT_FAILURE, so callers can return it directly
+ */
+static int violation(InvariantChecker *checker, const Event *event,
+                     const char *reason) {
+    char line[EVENT_LINE_LEN];
+    format_event(event, line, sizeof(line));
+    snprintf(checker->error, sizeof(checker->error), "%s (at \"%s\")", reason,
+             line);
+    return EXIT_FAILURE;
+}
+
+/**
+ * @brief Checks one ferry event
+ */
+static int feed_ferry(InvariantChecker *checker, const Event *event) {
+    switch (event->action) {
+        case EVENT_STARTED:
+            if (checker->ferry_started) {
+                return violation(checker, event, "ferry started twice");
+            }
+            checker->ferry_started = 1;
+            return EXIT_SUCCESS;
+        case EVENT_ARRIVED:
+            if (checker->ferry_docked || event->port < 0 || event->port > 1 ||
+                event->port == checker->ferry_port ||
+                (checker->ferry_port == -1 && event->port != 0)) {
+                return violation(checker, event, "ferry arrived out of turn");
+            }
+            checker->ferry_docked = 1;
+            checker->ferry_port = event->port;
+            checker->stop++;
+            checker->stop_load = 0;
+            checker->stop_boarded = 0;
+            return EXIT_SUCCESS;
+        case EVENT_LEAVING:
+            if (!checker->ferry_docked || event->port != checker->ferry_port) {
+                return violation(checker, event, "ferry left a port it is not at");
+            }
+            if (checker->on_deck != checker->stop_boarded) {
+                return violation(checker, event,
+                                 "ferry left before its deck was unloaded");
+            }
+            checker->ferry_docked = 0;
+            return EXIT_SUCCESS;
+        case EVENT_FINISH:
+            if (checker->ferry_docked || checker->ferry_finished) {
+                return violation(checker, event, "ferry finished while docked");
+            }
+            checker->ferry_finished = 1;
+            return EXIT_SUCCESS;
+        default:
+            return violation(checker, event, "invalid ferry action");
+    }
+}
+
+/**
+ * @brief Checks one vehicle event
+ */
+static int feed_vehicle(InvariantChecker *checker, const Event *event) {
+    int cls = class_find(&checker->classes, event->type);
+    // Vehicle indexes start at 1 in the checker
+    int index = class_vehicle_index(&checker->classes, cls, event->id) + 1;
+    if (index == 0) {
+        return violation(checker, event, "unknown vehicle");
+    }
+    int size = checker->classes.classes[cls].size;
+    // Vehicle actions must come exactly in the order of EventAction
+    if (checker->state[index] != event->action) {
+        return violation(checker, event, "vehicle action out of order");
+    }
+    checker->state[index] = event->action + 1;
+
+    switch (event->action) {
+        case EVENT_STARTED:
+            return EXIT_SUCCESS;
+        case EVENT_ARRIVED:
+            if (event->port < 0 || event->port > 1) {
+                return violation(checker, event, "invalid port");
+            }
+            // The way back starts where the last crossing ended
+            if (checker->crossed[index] > 0 &&
+                event->port == checker->port[index]) {
+                return violation(checker, event, "returned to the wrong port");
+            }
+            checker->port[index] = event->port;
+            return EXIT_SUCCESS;
+        case EVENT_BOARDING:
+            if (!checker->ferry_docked ||
+                checker->ferry_port != checker->port[index]) {
+                return violation(checker, event,
+                                 "boarding while the ferry is elsewhere");
+            }
+            checker->stop_load += size;
+            if (checker->stop_load > checker->capacity) {
+                return violation(checker, event, "ferry overloaded");
+            }
+            checker->stop_boarded++;
+            checker->on_deck++;
+            checker->boarded_stop[index] = checker->stop;
+            return EXIT_SUCCESS;
+        case EVENT_LEAVING_IN:
+            if (!checker->ferry_docked || event->port != checker->ferry_port ||
+                event->port == checker->port[index] ||
+                checker->boarded_stop[index] != checker->stop - 1) {
+                return violation(checker, event, "left at the wrong port");
+            }
+            if (checker->stop_boarded > 0) {
+                return violation(checker, event, "left after boarding started");
+            }
+            checker->on_deck--;
+            // Another crossing starts with another arrival
+            if (++checker->crossed[index] < checker->crossings) {
+                checker->state[index] = EVENT_ARRIVED;
+            }
+            return EXIT_SUCCESS;
+        default:
+            return violation(checker, event, "invalid vehicle action");
+    }
+}
+
+/**
+ * @brief Feeds the next event to the checker
+ * @param checker The checker
+ * @param event The event
+ * @return EXIT_SUCCESS if no invariant is violated, EXIT_FAILURE otherwise
+ */
+int invariant_feed(InvariantChecker *checker, const Event *event) {
+    if (event->number != checker->next_number) {
+        return violation(checker, event, "action counter is not continuous");
+    }
+    checker->next_number++;
+    if (checker->ferry_finished) {
+        return violation(checker, event, "event after the ferry finished");
+    }
+    if (event->type == 'P') {
+        return feed_ferry(checker, event);
+    }
+    return feed_vehicle(checker, event);
+}
+
+/**
+ * @brief Checks the end-of-run invariants after the last event
+ * @param checker The checker
+ * @return EXIT_SUCCESS if the run was complete, EXIT_FAILURE otherwise
+ */
+int invariant_finish(InvariantChecker *checker) {
+    if (!checker->ferry_finished) {
+        snprintf(checker->error, sizeof(checker->error),
+                 "ferry did not finish");
+        return EXIT_FAILURE;
+    }
+    for (int index = 1; index <= checker->classes.vehicles; index++) {
+        if (checker->state[index] != EVENT_LEAVING_IN + 1) {
+            int id;
+            int cls = class_of_vehicle(&checker->classes, index - 1, &id);
+            snprintf(checker->error, sizeof(checker->error),
+                     "%c %d did not complete its crossing",
+                     checker->classes.classes[cls].letter, id);
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Frees the per-vehicle state of a checker
+ * @param checker The checker
+ */
+void invariant_destroy(InvariantChecker *checker) {
+    free(checker->state);
+    free(checker->port);
+    free(checker->boarded_stop);
+    free(checker->crossed);
+    checker->state = NULL;
+    checker->port = NULL;
+    checker->boarded_stop = NULL;
+    checker->crossed = NULL;
+}
+
+/**
+ * @brief Validates a complete log file
+ * @param log The log, opened for reading
+ * @param classes Vehicles of each class in the run
+ * @param capacity Ferry capacity in units
+ * @param crossings Crossings every vehicle makes
+ * @param error Buffer for the description of the first violation
+ * @param error_size Size of the error buffer
+ * @return EXIT_SUCCESS if the log is valid, EXIT_FAILURE otherwise
+ */
+int invariant_check_file(FILE *log, const ClassTable *classes, int capacity,
+                         int crossings, char *error, size_t error_size) {
+    InvariantChecker checker;
+    char line[EVENT_LINE_LEN * 2];
+    int result = EXIT_SUCCESS;
+
+    if (invariant_init(&checker, classes, capacity, crossings)) {
+        snprintf(error, error_size, "out of memory");
+        return EXIT_FAILURE;
+    }
+    while (result == EXIT_SUCCESS && fgets(line, sizeof(line), log)) {
+        Event event;
+        if (parse_event_line(line, &event)) {
+            line[strcspn(line, "\n")] = '\0';
+            snprintf(checker.error, sizeof(checker.error),
+                     "malformed line \"%s\"", line);
+            result = EXIT_FAILURE;
+        } else {
+            result = invariant_feed(&checker, &event);
+        }
+    }
+    if (result == EXIT_SUCCESS) {
+        result = invariant_finish(&checker);
+    }
+    if (result != EXIT_SUCCESS) {
+        snprintf(error, error_size, "%s", checker.error);
+    }
+    invariant_destroy(&checker);
+    return result;
+}
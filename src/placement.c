@@ -0,0 +1,124 @@
+#include "placement.h"
+
+#include <linux/mempolicy.h>  // MPOL_PREFERRED, MPOL_MF_MOVE
+#include <stdio.h>            // fprintf
+#include <stdlib.h>           // strtol
+#include <sys/resource.h>     // setpriority
+#include <sys/syscall.h>      // SYS_mbind
+#include <unistd.h>           // syscall
+
+/**
+ * @brief Parses a CPU list such as "0,2-5" into a CPU set
+ * @param list Comma separated CPU numbers and inclusive ranges
+ * @param set CPU set to fill
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ */
+int parse_cpu_list(const char *list, cpu_set_t *set) {
+    const char *pos = list;
+    CPU_ZERO(set);
+
+    while (*pos != '\0') {
+        char *end;
+        long first = strtol(pos, &end, 10);
+        long last = first;
+        if (end == pos) {
+            break;
+        }
+        if (*end == '-') {
+            pos = end + 1;
+            last = strtol(pos, &end, 10);
+            if (end == pos) {
+                break;
+            }
+        }
+        if (first < 0 || last < first || last >= CPU_SETSIZE) {
+            break;
+        }
+        for (long cpu = first; cpu <= last; cpu++) {
+            CPU_SET(cpu, set);
+        }
+        if (*end == '\0') {
+            return EXIT_SUCCESS;
+        }
+        if (*end != ',') {
+            break;
+        }
+        pos = end + 1;
+    }
+
+    fprintf(stderr, "[ERROR] Invalid CPU list: %s\n", list);
+    return EXIT_FAILURE;
+}
+
+/**
+ * @brief Pins the calling process to a single CPU
+ * @param cpu CPU number
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ */
+int pin_to_cpu(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pin_to_cpu_set(&set);
+}
+
+/**
+ * @brief Confines the calling process to a set of CPUs
+ * @param set Allowed CPUs
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ */
+int pin_to_cpu_set(const cpu_set_t *set) {
+    if (sched_setaffinity(0, sizeof(cpu_set_t), set) == -1) {
+        perror("[WARNING] sched_setaffinity failed");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Moves the calling process to the SCHED_FIFO real-time class
+ * @param priority Real-time priority (1-99)
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ *
+ * Needs CAP_SYS_NICE or a matching RLIMIT_RTPRIO.
+ */
+int set_fifo_priority(int priority) {
+    struct sched_param param = {.sched_priority = priority};
+    if (sched_setscheduler(0, SCHED_FIFO, &param) == -1) {
+        perror("[WARNING] sched_setscheduler(SCHED_FIFO) failed");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Lowers the nice value of the calling process
+ * @param boost How many nice levels to gain
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ */
+int boost_priority(int boost) {
+    int current = getpriority(PRIO_PROCESS, 0);
+    if (setpriority(PRIO_PROCESS, 0, current - boost) == -1) {
+        perror("[WARNING] setpriority failed");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Prefers a NUMA node for a memory range and migrates its pages
+ * @param addr Page aligned start of the range
+ * @param length Length of the range in bytes
+ * @param node NUMA node number
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ */
+int bind_to_numa_node(void *addr, size_t length, int node) {
+    unsigned long nodemask = 1UL << node;
+    // The kernel reads one bit less than maxnode, keep node 63 in the mask
+    if (syscall(SYS_mbind, addr, length, MPOL_PREFERRED, &nodemask,
+                sizeof(nodemask) * 8 + 1, MPOL_MF_MOVE) == -1) {
+        perror("[WARNING] mbind failed");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,973 @@
+#include "port_server.h"
+
+#include <arpa/inet.h>    // htonl
+#include <errno.h>        // EINTR
+#include <netinet/in.h>   // sockaddr_in
+#include <netinet/tcp.h>  // TCP_NODELAY
+#include <poll.h>         // ppoll
+#include <sys/epoll.h>    // epoll_wait
+#include <sys/resource.h> // setrlimit
+#include <sys/socket.h>   // socket
+#include <sys/un.h>       // sockaddr_un
+
+// --- Constants ---
+#define PORT_SERVER_EVENTS 64  // Events taken per epoll_wait
+
+// --- Link names as given to --ports ---
+static const char *LINK_NAMES[] = {
+    [PORT_LINK_SHARED] = "shared",
+    [PORT_LINK_UNIX] = "unix",
+    [PORT_LINK_TCP] = "tcp",
+};
+
+// --- Process-local ends of the links, copied by fork ---
+static int link_mode = PORT_LINK_SHARED;
+static int ferry_fd[2] = {-1, -1};   // Ferry end of each link
+static int listen_fd[2] = {-1, -1};  // Listener of each server
+static struct sockaddr_storage port_addr[2]; // Where the vehicles connect
+static socklen_t port_addr_len[2];
+static int links_opened = 0;  // Keeps the unix names of the runs apart
+
+// --- Server side ---
+typedef struct {
+    int fd;                // Connection of the vehicle
+    int cls;               // Class of the vehicle
+    int entry;             // Vehicle table entry of the vehicle
+    long long arrived_ns;  // Arrival, used by the boarding policy
+} PortVehicle;
+
+typedef struct {
+    PortVehicle **items;   // Ring of vehicles, oldest first
+    int size;              // Capacity of the ring
+    int head;              // Index of the oldest vehicle
+    int len;               // Vehicles in the ring
+} VehicleQueue;
+
+typedef struct {
+    SharedData *shared_data;
+    int port;                    // The port served
+    int classes;                 // Vehicle classes of the run
+    int queue_limit;             // Places in the queue, 0 without a limit
+    int ferry;                   // Connection of the ferry
+    int listener;                // Where the vehicles connect
+    int epoll;                   // Ferry, listener and arriving vehicles
+    VehicleQueue queue[MAX_VEHICLE_CLASSES]; // Waiting vehicles per class
+    VehicleQueue held;           // Vehicles held back by a full queue
+    int admitted;                // Admitted vehicles not on board yet
+    BoardingState boarding;      // Boarding policy state of the port
+    Deck deck;                   // Vehicles the port put on the deck
+    PortVehicle *on_deck[MAX_DECK_SLOTS];
+    long long arrivals;          // Arrivals at the port so far
+    long long last_arrival_ns;   // Latest arrival
+    long long arrival_gap_ns;    // Smoothed gap between arrivals
+    long long messages;          // Vehicle messages not reported yet
+    int wait_pending;            // A WAIT of the ferry is not answered yet
+} PortServer;
+
+/**
+ * @brief Looks up a port link mode by name
+ * @param name Name of the mode
+ * @return The mode, or -1 if there is no such mode
+ */
+int port_link_find(const char *name) {
+    for (size_t i = 0; i < sizeof(LINK_NAMES) / sizeof(LINK_NAMES[0]); i++) {
+        if (strcmp(name, LINK_NAMES[i]) == 0) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Returns the name of a port link mode
+ */
+const char *port_link_name(int mode) {
+    return LINK_NAMES[mode];
+}
+
+/**
+ * @brief Closes a descriptor if it is open
+ * @param fd The descriptor, set to -1
+ */
+static void close_fd(int *fd) {
+    if (*fd != -1) {
+        close(*fd);
+        *fd = -1;
+    }
+}
+
+/**
+ * @brief Opens a socket of the link mode and connects it to a port
+ * @param port The port
+ * @return The socket, or -1 on failure
+ */
+static int connect_port(int port) {
+    int fd = socket(port_addr[port].ss_family, SOCK_STREAM, 0);
+    int one = 1;
+    if (fd == -1) {
+        return -1;
+    }
+    if (connect(fd, (struct sockaddr *)&port_addr[port],
+                port_addr_len[port]) == -1 ||
+        (link_mode == PORT_LINK_TCP &&
+         setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)) == -1)) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief Opens the listener of a port and remembers its address
+ * @param port The port
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ *
+ * unix listeners have an abstract name, so nothing is left in the file
+ * system, tcp listeners take a free loopback port.
+ */
+static int listen_port(int port) {
+    memset(&port_addr[port], 0, sizeof(port_addr[port]));
+    if (link_mode == PORT_LINK_UNIX) {
+        struct sockaddr_un *addr = (struct sockaddr_un *)&port_addr[port];
+        addr->sun_family = AF_UNIX;
+        // Abstract names start with a zero byte and are not terminated
+        int len = snprintf(addr->sun_path + 1, sizeof(addr->sun_path) - 1,
+                           "ferry-%d-%d-%d", (int)getpid(), links_opened,
+                           port);
+        port_addr_len[port] = offsetof(struct sockaddr_un, sun_path) + 1 + len;
+    } else {
+        struct sockaddr_in *addr = (struct sockaddr_in *)&port_addr[port];
+        addr->sin_family = AF_INET;
+        addr->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        port_addr_len[port] = sizeof(*addr);
+    }
+    listen_fd[port] = socket(port_addr[port].ss_family, SOCK_STREAM, 0);
+    return listen_fd[port] == -1 ||
+                   bind(listen_fd[port], (struct sockaddr *)&port_addr[port],
+                        port_addr_len[port]) == -1 ||
+                   listen(listen_fd[port], SOMAXCONN) == -1 ||
+                   getsockname(listen_fd[port],
+                               (struct sockaddr *)&port_addr[port],
+                               &port_addr_len[port]) == -1
+               ? EXIT_FAILURE
+               : EXIT_SUCCESS;
+}
+
+/**
+ * @brief Opens the links to both ports, before the ferry and servers fork
+ * @param mode The PortLinkMode
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ *
+ * The ferry connects first and waits in the backlog until the server
+ * accepts it, so nothing can fail after the processes forked.
+ */
+int port_links_open(int mode) {
+    link_mode = mode;
+    links_opened++;
+    for (int port = 0; port < 2 && mode != PORT_LINK_SHARED; port++) {
+        if (listen_port(port) != EXIT_SUCCESS ||
+            (ferry_fd[port] = connect_port(port)) == -1) {
+            fprintf(stderr, "[ERROR] Failed to open the link to port %d\n",
+                    port);
+            port_links_close();
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Closes every end of the links held by the calling process
+ *
+ * The addresses stay, the vehicles forked later connect to them.
+ */
+void port_links_close(void) {
+    for (int port = 0; port < 2; port++) {
+        close_fd(&ferry_fd[port]);
+        close_fd(&listen_fd[port]);
+    }
+}
+
+/**
+ * @brief Keeps only the ferry ends of the links in the ferry
+ *
+ * Drops the listeners the ferry inherited, so a server sees the end of
+ * its link once the ferry exits.
+ */
+void port_links_attach_ferry(void) {
+    for (int port = 0; port < 2; port++) {
+        close_fd(&listen_fd[port]);
+    }
+}
+
+/**
+ * @brief Sends or receives a whole message
+ * @param fd The socket
+ * @param buf The message
+ * @param size Size of the message
+ * @param sending 1 to send, 0 to receive
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE at the end of the link
+ *
+ * A peer that went away fails the send instead of raising SIGPIPE.
+ */
+static int transfer(int fd, void *buf, size_t size, int sending) {
+    char *next = buf;
+    while (size > 0) {
+        ssize_t done = sending ? send(fd, next, size, MSG_NOSIGNAL)
+                               : read(fd, next, size);
+        if (done == -1 && errno == EINTR) {
+            continue;
+        }
+        if (done <= 0) {
+            return EXIT_FAILURE;
+        }
+        next += done;
+        size -= done;
+    }
+    return EXIT_SUCCESS;
+}
+
+// --- Ferry side ---
+
+/**
+ * @brief Sends a request to a port server
+ * @param shared_data Pointer to shared data
+ * @param port The port
+ * @param type The PortRequestType
+ * @param remaining LOAD: free units on the deck
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE if the link failed
+ */
+static int send_request(SharedData *shared_data, int port, int type,
+                        int remaining) {
+    PortRequest request = {type, remaining};
+    // Only the ferry writes the link counters
+    shared_data->port_messages[port]++;
+    return transfer(ferry_fd[port], &request, sizeof(request), 1);
+}
+
+/**
+ * @brief Receives the reply of a port server
+ * @param shared_data Pointer to shared data
+ * @param port The port
+ * @param reply Where to store the reply
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE if the link failed
+ *
+ * The server's messages to and from its vehicles count toward the link.
+ */
+static int receive_reply(SharedData *shared_data, int port,
+                         PortReply *reply) {
+    if (transfer(ferry_fd[port], reply, sizeof(*reply), 0) != EXIT_SUCCESS) {
+        return EXIT_FAILURE;
+    }
+    shared_data->port_messages[port] += 1 + reply->messages;
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Sends a request to a port server and waits for its reply
+ * @param shared_data Pointer to shared data
+ * @param port The port
+ * @param type The PortRequestType
+ * @param remaining LOAD: free units on the deck
+ * @param reply Where to store the reply
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE if the link failed
+ */
+static int request_port(SharedData *shared_data, int port, int type,
+                        int remaining, PortReply *reply) {
+    long long start = now_ns();
+    if (send_request(shared_data, port, type, remaining) ||
+        receive_reply(shared_data, port, reply)) {
+        fprintf(stderr, "[ERROR] Lost the link to port %d\n", port);
+        return EXIT_FAILURE;
+    }
+    histogram_record(&shared_data->port_rtt[port], now_ns() - start);
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Asks a port server to call vehicles on board
+ * @param shared_data Pointer to shared data
+ * @param port Port the ferry is docked at
+ * @param remaining Free units on the deck
+ * @return Number of vehicles on board, -1 if the link failed
+ *
+ * The server replies once the vehicles it called are on board, the ferry
+ * adds them to its deck.
+ */
+int port_link_load(SharedData *shared_data, int port, int remaining) {
+    PortReply reply;
+    if (request_port(shared_data, port, PORT_REQUEST_LOAD, remaining,
+                     &reply) != EXIT_SUCCESS) {
+        return -1;
+    }
+    sync_wait(&shared_data->lock_mutex);
+    for (int cls = 0; cls < shared_data->classes.count; cls++) {
+        shared_data->loaded[cls] += reply.boarded[cls];
+    }
+    shared_data->vehicles_to_unload += reply.called;
+    sync_post(&shared_data->lock_mutex);
+    return reply.called;
+}
+
+/**
+ * @brief Asks a port server to let the vehicles it put on the deck leave
+ * @param shared_data Pointer to shared data
+ * @param port Port the vehicles boarded at
+ * @return Number of vehicles that left, -1 if the link failed
+ */
+int port_link_unload(SharedData *shared_data, int port) {
+    PortReply reply;
+    if (request_port(shared_data, port, PORT_REQUEST_UNLOAD, 0, &reply) !=
+        EXIT_SUCCESS) {
+        return -1;
+    }
+    return reply.called;
+}
+
+/**
+ * @brief Asks a port server for its queue and arrivals
+ * @param shared_data Pointer to shared data
+ * @param port The port
+ * @param status Where to store the reply
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE if the link failed
+ */
+int port_link_status(SharedData *shared_data, int port, PortReply *status) {
+    return request_port(shared_data, port, PORT_REQUEST_STATUS, 0, status);
+}
+
+/**
+ * @brief Sleeps until a vehicle arrives at one of the given ports
+ * @param shared_data Pointer to shared data
+ * @param ports Whether to wait on port 0 and port 1
+ * @param deadline Monotonic time to give up at, -1 to wait without one
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE if a link failed
+ *
+ * Every port waited on gets a WAIT. The ones that did not answer by the
+ * first answer or the deadline get a CANCEL, which the server answers
+ * after the WAIT, so each link carries exactly two replies then.
+ */
+int port_link_wait(SharedData *shared_data, const int ports[2],
+                   long long deadline) {
+    struct pollfd fds[2];
+    int waited[2];
+    int count = 0;
+    for (int port = 0; port < 2; port++) {
+        if (!ports[port]) {
+            continue;
+        }
+        if (send_request(shared_data, port, PORT_REQUEST_WAIT, 0) !=
+            EXIT_SUCCESS) {
+            fprintf(stderr, "[ERROR] Lost the link to port %d\n", port);
+            return EXIT_FAILURE;
+        }
+        fds[count] = (struct pollfd){.fd = ferry_fd[port], .events = POLLIN};
+        waited[count++] = port;
+    }
+
+    int ready;
+    do {
+        struct timespec timeout = {0, 0};
+        long long remaining_ns = deadline - now_ns();
+        if (remaining_ns > 0) {
+            timeout.tv_sec = remaining_ns / NS_PER_SEC;
+            timeout.tv_nsec = remaining_ns % NS_PER_SEC;
+        }
+        ready = ppoll(fds, count, deadline >= 0 ? &timeout : NULL, NULL);
+    } while (ready == -1 && errno == EINTR);
+
+    for (int i = 0; i < count; i++) {
+        int port = waited[i];
+        int answered = ready > 0 && fds[i].revents != 0;
+        PortReply reply;
+        if ((!answered && send_request(shared_data, port,
+                                       PORT_REQUEST_CANCEL, 0)) ||
+            receive_reply(shared_data, port, &reply) ||
+            (!answered && receive_reply(shared_data, port, &reply))) {
+            fprintf(stderr, "[ERROR] Lost the link to port %d\n", port);
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Tells both port servers the run is over
+ */
+void port_links_stop(void) {
+    PortRequest request = {PORT_REQUEST_STOP, 0};
+    for (int port = 0; port < 2 && link_mode != PORT_LINK_SHARED; port++) {
+        transfer(ferry_fd[port], &request, sizeof(request), 1);
+        close_fd(&ferry_fd[port]);
+    }
+}
+
+// --- Vehicle side ---
+
+/**
+ * @brief Connects a vehicle to the server of a port and asks for a place
+ * @param port The port the vehicle arrives at
+ * @param cls The class of the vehicle
+ * @param entry Vehicle table entry of the vehicle
+ * @param held Set to 1 if the queue was full and the vehicle has to wait
+ * for ADMIT, 0 if it was admitted at once
+ * @return The connection, or -1 if the link failed
+ */
+int port_link_arrive(int port, int cls, int entry, int *held) {
+    int fd = connect_port(port);
+    PortVehicleMessage message = {PORT_VEHICLE_ARRIVE, cls, entry, 0};
+    if (fd == -1) {
+        return -1;
+    }
+    if (transfer(fd, &message, sizeof(message), 1) ||
+        transfer(fd, &message, sizeof(message), 0) ||
+        (message.type != PORT_VEHICLE_HOLD &&
+         message.type != PORT_VEHICLE_ADMIT)) {
+        close(fd);
+        return -1;
+    }
+    *held = message.type == PORT_VEHICLE_HOLD;
+    return fd;
+}
+
+/**
+ * @brief Sends a message of a vehicle to its port server
+ * @param fd Connection of the vehicle
+ * @param type The PortVehicleMessageType
+ * @param time_ns ARRIVED: when the vehicle arrived
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE if the link failed
+ */
+int port_link_send(int fd, int type, long long time_ns) {
+    PortVehicleMessage message = {type, 0, 0, time_ns};
+    return transfer(fd, &message, sizeof(message), 1);
+}
+
+/**
+ * @brief Waits for a message of the port server to a vehicle
+ * @param fd Connection of the vehicle
+ * @param type The PortVehicleMessageType expected
+ * @return EXIT_SUCCESS if it came, EXIT_FAILURE otherwise
+ */
+int port_link_await(int fd, int type) {
+    PortVehicleMessage message;
+    if (transfer(fd, &message, sizeof(message), 0) != EXIT_SUCCESS ||
+        message.type != type) {
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+// --- Server side ---
+
+/**
+ * @brief Allocates an empty vehicle queue
+ * @param queue The queue
+ * @param size Most vehicles the queue holds at once
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ */
+static int vehicle_queue_init(VehicleQueue *queue, int size) {
+    queue->size = size > 0 ? size : 1;
+    queue->head = 0;
+    queue->len = 0;
+    queue->items = malloc(queue->size * sizeof(*queue->items));
+    return queue->items == NULL ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/**
+ * @brief Appends a vehicle to a queue
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE if the queue is full
+ */
+static int vehicle_queue_push(VehicleQueue *queue, PortVehicle *vehicle) {
+    if (queue->len == queue->size) {
+        return EXIT_FAILURE;
+    }
+    queue->items[(queue->head + queue->len) % queue->size] = vehicle;
+    queue->len++;
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Removes the oldest vehicle of a non-empty queue
+ */
+static PortVehicle *vehicle_queue_pop(VehicleQueue *queue) {
+    PortVehicle *vehicle = queue->items[queue->head];
+    queue->head = (queue->head + 1) % queue->size;
+    queue->len--;
+    return vehicle;
+}
+
+/**
+ * @brief Closes the connection of a vehicle and frees it
+ */
+static void drop_vehicle(PortVehicle *vehicle) {
+    close(vehicle->fd);
+    free(vehicle);
+}
+
+/**
+ * @brief Frees a queue and the vehicles still in it
+ */
+static void vehicle_queue_free(VehicleQueue *queue) {
+    while (queue->items != NULL && queue->len > 0) {
+        drop_vehicle(vehicle_queue_pop(queue));
+    }
+    free(queue->items);
+    queue->items = NULL;
+}
+
+/**
+ * @brief Returns the number of vehicles waiting at the port
+ */
+static int server_waiting(const PortServer *server) {
+    int vehicles = 0;
+    for (int cls = 0; cls < server->classes; cls++) {
+        vehicles += server->queue[cls].len;
+    }
+    return vehicles;
+}
+
+/**
+ * @brief Publishes the queue of a class to the statistics
+ * @param server The server
+ * @param cls The class whose queue changed
+ * @param arrived 1 if a vehicle arrived, 0 if one boarded
+ */
+static void publish_queue(PortServer *server, int cls, int arrived) {
+    SharedData *shared_data = server->shared_data;
+    int port = server->port;
+    sync_wait(&shared_data->lock_mutex);
+    shared_data->waiting[cls][port] = server->queue[cls].len;
+    int waiting = port_waiting(shared_data, port);
+    if (waiting > shared_data->peak_waiting[port]) {
+        shared_data->peak_waiting[port] = waiting;
+    }
+    shared_data->arrived_vehicles += arrived;
+    sync_post(&shared_data->lock_mutex);
+}
+
+/**
+ * @brief Sends a message of the server to a vehicle
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE if the vehicle is gone
+ */
+static int tell_vehicle(PortServer *server, PortVehicle *vehicle, int type) {
+    server->messages++;
+    return port_link_send(vehicle->fd, type, 0);
+}
+
+/**
+ * @brief Sends a message to a vehicle and waits for its answer
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE if the vehicle is gone
+ */
+static int ask_vehicle(PortServer *server, PortVehicle *vehicle, int type,
+                       int answer) {
+    server->messages += 2;
+    return port_link_send(vehicle->fd, type, 0) ||
+           port_link_await(vehicle->fd, answer);
+}
+
+/**
+ * @brief Gives a vehicle a place in the queue
+ */
+static int admit(PortServer *server, PortVehicle *vehicle) {
+    server->admitted++;
+    return tell_vehicle(server, vehicle, PORT_VEHICLE_ADMIT);
+}
+
+/**
+ * @brief Sends a reply to the ferry
+ * @param server The server
+ * @param reply The reply, the queue and arrivals are filled in here
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE if the ferry is gone
+ */
+static int reply_ferry(PortServer *server, PortReply *reply) {
+    reply->waiting = server_waiting(server);
+    reply->arrivals = server->arrivals;
+    reply->arrival_gap_ns = server->arrival_gap_ns;
+    reply->messages = server->messages;
+    server->messages = 0;
+    return transfer(server->ferry, reply, sizeof(*reply), 1);
+}
+
+/**
+ * @brief Answers a pending WAIT of the ferry
+ */
+static int answer_wait(PortServer *server) {
+    PortReply reply = {0};
+    server->wait_pending = 0;
+    return reply_ferry(server, &reply);
+}
+
+/**
+ * @brief Calls waiting vehicles on board in the order of the policy
+ * @param server The server
+ * @param remaining Free units on the deck
+ * @param reply Where to count the vehicles on board
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE if a vehicle is gone
+ *
+ * Each vehicle answers once it logged its boarding, so the reply to the
+ * ferry comes after every boarding of the batch.
+ */
+static int serve_load(PortServer *server, int remaining, PortReply *reply) {
+    while (remaining > 0) {
+        BoardingView view;
+        long long now = now_ns();
+        view.classes = server->classes;
+        for (int cls = 0; cls < server->classes; cls++) {
+            VehicleQueue *queue = &server->queue[cls];
+            view.waiting[cls] = queue->len;
+            view.head_ns[cls] =
+                queue->len > 0 ? queue->items[queue->head]->arrived_ns : now;
+        }
+        view.size = server->boarding.size;
+        view.remaining = remaining;
+        int cls = boarding_pick(&server->boarding, &view);
+        if (cls == BOARDING_NONE) {
+            break;
+        }
+        PortVehicle *vehicle = vehicle_queue_pop(&server->queue[cls]);
+        publish_queue(server, cls, 0);
+        if (ask_vehicle(server, vehicle, PORT_VEHICLE_BOARD,
+                        PORT_VEHICLE_BOARDED) != EXIT_SUCCESS) {
+            drop_vehicle(vehicle);
+            return EXIT_FAILURE;
+        }
+        server->on_deck[deck_park(&server->deck, vehicle->entry)] = vehicle;
+        remaining -= server->boarding.size[cls];
+        reply->called++;
+        reply->boarded[cls]++;
+        // The place in the queue goes to the next held vehicle
+        server->admitted--;
+        if (server->held.len > 0 &&
+            admit(server, vehicle_queue_pop(&server->held)) != EXIT_SUCCESS) {
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Lets the vehicles the port put on the deck leave, one by one
+ * @param server The server
+ * @param reply Where to count the vehicles that left
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE if a vehicle is gone
+ */
+static int serve_unload(PortServer *server, PortReply *reply) {
+    int slot = deck_plan_unload(&server->deck);
+    while (slot != DECK_NONE) {
+        PortVehicle *vehicle = server->on_deck[slot];
+        int next = server->deck.next[slot];
+        server->on_deck[slot] = NULL;
+        int failed = ask_vehicle(server, vehicle, PORT_VEHICLE_LEAVE,
+                                 PORT_VEHICLE_LEFT);
+        drop_vehicle(vehicle);
+        if (failed) {
+            return EXIT_FAILURE;
+        }
+        reply->called++;
+        slot = next;
+    }
+    deck_clear(&server->deck);
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Answers a request of the ferry
+ * @param server The server
+ * @return 1 to go on, 0 once the run is over or a link failed
+ */
+static int serve_ferry(PortServer *server) {
+    PortRequest request;
+    PortReply reply = {0};
+    if (transfer(server->ferry, &request, sizeof(request), 0) !=
+        EXIT_SUCCESS) {
+        return 0;
+    }
+    switch (request.type) {
+    case PORT_REQUEST_LOAD:
+        if (serve_load(server, request.remaining, &reply) != EXIT_SUCCESS) {
+            fprintf(stderr, "[ERROR] Port %d lost a boarding vehicle\n",
+                    server->port);
+            return 0;
+        }
+        break;
+    case PORT_REQUEST_UNLOAD:
+        if (serve_unload(server, &reply) != EXIT_SUCCESS) {
+            fprintf(stderr, "[ERROR] Port %d lost a leaving vehicle\n",
+                    server->port);
+            return 0;
+        }
+        break;
+    case PORT_REQUEST_STATUS:
+        break;
+    case PORT_REQUEST_WAIT:
+        if (server_waiting(server) == 0) {
+            server->wait_pending = 1;
+            return 1;
+        }
+        break;
+    case PORT_REQUEST_CANCEL:
+        if (server->wait_pending && answer_wait(server) != EXIT_SUCCESS) {
+            return 0;
+        }
+        break;
+    default:
+        return 0;
+    }
+    return reply_ferry(server, &reply) == EXIT_SUCCESS;
+}
+
+/**
+ * @brief Accepts the connection of an arriving vehicle
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ */
+static int accept_vehicle(PortServer *server) {
+    PortVehicle *vehicle = calloc(1, sizeof(*vehicle));
+    int one = 1;
+    if (vehicle == NULL) {
+        return EXIT_FAILURE;
+    }
+    while ((vehicle->fd = accept(server->listener, NULL, NULL)) == -1 &&
+           errno == EINTR);
+    struct epoll_event event = {.events = EPOLLIN, .data.ptr = vehicle};
+    if (vehicle->fd == -1 ||
+        (link_mode == PORT_LINK_TCP &&
+         setsockopt(vehicle->fd, IPPROTO_TCP, TCP_NODELAY, &one,
+                    sizeof(one)) == -1) ||
+        epoll_ctl(server->epoll, EPOLL_CTL_ADD, vehicle->fd, &event) == -1) {
+        if (vehicle->fd != -1) {
+            close(vehicle->fd);
+        }
+        free(vehicle);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Queues a vehicle that logged its arrival
+ * @param server The server
+ * @param vehicle The vehicle
+ * @param arrived_ns When it arrived
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ *
+ * The vehicle stays silent until it is called, so it leaves the epoll set.
+ */
+static int queue_vehicle(PortServer *server, PortVehicle *vehicle,
+                         long long arrived_ns) {
+    if (epoll_ctl(server->epoll, EPOLL_CTL_DEL, vehicle->fd, NULL) == -1 ||
+        vehicle_queue_push(&server->queue[vehicle->cls], vehicle) !=
+            EXIT_SUCCESS) {
+        return EXIT_FAILURE;
+    }
+    vehicle->arrived_ns = arrived_ns;
+    server->arrivals++;
+    server->arrival_gap_ns = arrival_gap_update(
+        server->arrival_gap_ns, server->last_arrival_ns, arrived_ns);
+    if (arrived_ns > server->last_arrival_ns) {
+        server->last_arrival_ns = arrived_ns;
+    }
+    publish_queue(server, vehicle->cls, 1);
+    return server->wait_pending ? answer_wait(server) : EXIT_SUCCESS;
+}
+
+/**
+ * @brief Handles a message of a vehicle that has not arrived yet
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ *
+ * A vehicle asks for a place first and is admitted at once, or held
+ * until a vehicle of the full queue boards. Once admitted it logs its
+ * arrival and reports it.
+ */
+static int serve_vehicle(PortServer *server, PortVehicle *vehicle) {
+    PortVehicleMessage message;
+    if (transfer(vehicle->fd, &message, sizeof(message), 0) !=
+        EXIT_SUCCESS) {
+        return EXIT_FAILURE;
+    }
+    server->messages++;
+    if (message.type == PORT_VEHICLE_ARRIVE && message.cls >= 0 &&
+        message.cls < server->classes) {
+        vehicle->cls = message.cls;
+        vehicle->entry = message.entry;
+        if (server->queue_limit == 0 ||
+            server->admitted < server->queue_limit) {
+            return admit(server, vehicle);
+        }
+        return vehicle_queue_push(&server->held, vehicle) ||
+               tell_vehicle(server, vehicle, PORT_VEHICLE_HOLD);
+    }
+    if (message.type == PORT_VEHICLE_ARRIVED) {
+        return queue_vehicle(server, vehicle, message.time_ns);
+    }
+    return EXIT_FAILURE;
+}
+
+/**
+ * @brief Sets up the state of a server
+ * @param server The server, its links already set
+ * @param cfg Configuration structure
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ *
+ * A vehicle waits at one port at a time, so a queue never holds more
+ * vehicles than its class has.
+ */
+static int server_init(PortServer *server, Config cfg) {
+    server->classes = cfg.classes.count;
+    server->queue_limit = cfg.queue_limit;
+    boarding_init(&server->boarding, cfg.boarding_policy, &cfg.classes);
+    deck_init(&server->deck, cfg.unload_order, cfg.deck_lanes);
+    for (int cls = 0; cls < server->classes; cls++) {
+        if (vehicle_queue_init(&server->queue[cls],
+                               cfg.classes.classes[cls].count) !=
+            EXIT_SUCCESS) {
+            return EXIT_FAILURE;
+        }
+    }
+    if (vehicle_queue_init(&server->held, cfg.classes.vehicles) !=
+        EXIT_SUCCESS) {
+        return EXIT_FAILURE;
+    }
+    server->epoll = epoll_create1(0);
+    struct epoll_event ferry = {.events = EPOLLIN, .data.ptr = &server->ferry};
+    struct epoll_event listener = {.events = EPOLLIN,
+                                   .data.ptr = &server->listener};
+    if (server->epoll == -1 ||
+        epoll_ctl(server->epoll, EPOLL_CTL_ADD, server->ferry, &ferry) == -1 ||
+        epoll_ctl(server->epoll, EPOLL_CTL_ADD, server->listener, &listener) ==
+            -1) {
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Releases the state of a server
+ */
+static void server_free(PortServer *server) {
+    for (int cls = 0; cls < server->classes; cls++) {
+        vehicle_queue_free(&server->queue[cls]);
+    }
+    vehicle_queue_free(&server->held);
+    for (int slot = 0; slot < MAX_DECK_SLOTS; slot++) {
+        if (server->on_deck[slot] != NULL) {
+            drop_vehicle(server->on_deck[slot]);
+        }
+    }
+    close_fd(&server->epoll);
+    close_fd(&server->ferry);
+    close_fd(&server->listener);
+}
+
+/**
+ * @brief Lets the server hold as many connections as the system allows
+ *
+ * Every waiting vehicle keeps its connection open, which passes the
+ * usual soft limit of 1024 descriptors on big runs.
+ */
+static void raise_fd_limit(void) {
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 &&
+        limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+/**
+ * @brief Main function for the server process of a port
+ * @param shared_data Pointer to the shared data
+ * @param cfg Configuration structure
+ * @param port The port served
+ *
+ * Serves the ferry and the vehicles of the port until the ferry stops the
+ * run or a link fails. The vehicles that have not arrived yet are the
+ * only ones in the epoll set; the ones called on board or off the deck
+ * are answered in turn.
+ */
+void port_server_process(SharedData *shared_data, Config cfg, int port) {
+    PortServer server = {.shared_data = shared_data,
+                         .port = port,
+                         .ferry = -1,
+                         .listener = listen_fd[port],
+                         .epoll = -1};
+    listen_fd[port] = -1;
+    port_links_close();
+    raise_fd_limit();
+    // The ferry connected before the fork, so it is accepted first
+    while ((server.ferry = accept(server.listener, NULL, NULL)) == -1 &&
+           errno == EINTR);
+    if (server.ferry == -1 || server_init(&server, cfg) != EXIT_SUCCESS) {
+        fprintf(stderr, "[ERROR] Port %d failed to start its server\n", port);
+        server_free(&server);
+        return;
+    }
+
+    int running = 1;
+    while (running) {
+        struct epoll_event events[PORT_SERVER_EVENTS];
+        int ready = epoll_wait(server.epoll, events, PORT_SERVER_EVENTS, -1);
+        if (ready == -1 && errno == EINTR) {
+            continue;
+        }
+        running = ready > 0;
+        for (int i = 0; i < ready && running; i++) {
+            void *tag = events[i].data.ptr;
+            if (tag == &server.ferry) {
+                running = serve_ferry(&server);
+            } else if (tag == &server.listener) {
+                running = accept_vehicle(&server) == EXIT_SUCCESS;
+            } else if (serve_vehicle(&server, tag) != EXIT_SUCCESS) {
+                fprintf(stderr, "[ERROR] Port %d lost an arriving vehicle\n",
+                        port);
+                running = 0;
+            }
+        }
+    }
+    server_free(&server);
+}
+
+/**
+ * @brief Creates the server process of a port
+ * @param shared_data Pointer to the shared data
+ * @param cfg Configuration structure
+ * @param port The port served
+ * @return PID of the server
+ */
+pid_t create_port_process(SharedData *shared_data, Config cfg, int port) {
+    pid_t server_pid = fork();
+    if (server_pid == 0) {
+        // Stall kills reach the servers with the ferry and vehicles
+        if (shared_data->sim_pgid > 0) {
+            setpgid(0, shared_data->sim_pgid);
+        }
+        apply_helper_placement(cfg);
+        port_server_process(shared_data, cfg, port);
+        _exit(EXIT_SUCCESS);
+    } else if (server_pid < 0) {
+        fprintf(stderr, "[ERROR] fork failed\n");
+        exit(EXIT_FAILURE);
+    }
+    if (shared_data->sim_pgid > 0) {
+        setpgid(server_pid, shared_data->sim_pgid);
+    }
+    shared_data->port_pid[port] = server_pid;
+    return server_pid;
+}
+
+/**
+ * @brief Prints the message counts and round trips of the port links
+ * @param shared_data Pointer to the shared data
+ * @param out Output stream
+ */
+void print_port_link_stats(SharedData *shared_data, FILE *out) {
+    if (shared_data->port_link == PORT_LINK_SHARED) {
+        return;
+    }
+    fprintf(out, "Port links over %s: %lld messages at port 0, %lld at "
+                 "port 1\n",
+            port_link_name(shared_data->port_link),
+            shared_data->port_messages[0], shared_data->port_messages[1]);
+    fprintf(out, "  %-28s %8s %9s %9s %9s %9s %9s\n", "request round trip (ms)",
+            "count", "mean", "p50", "p99", "p99.9", "max");
+    histogram_print(&shared_data->port_rtt[0], "port 0", out);
+    histogram_print(&shared_data->port_rtt[1], "port 1", out);
+}
@@ -0,0 +1,141 @@
+#include "publisher.h"
+
+#include <fcntl.h>  // O_CREAT
+
+/**
+ * @brief Creates and maps the named stats segment
+ * @param name Name of the segment, e.g. "/ferry"
+ * @return Pointer to the mapped segment, or NULL on failure
+ */
+LiveStats *live_stats_create(const char *name) {
+    int fd = shm_open(name, O_CREAT | O_RDWR | O_TRUNC, 0644);
+    if (fd == -1) {
+        fprintf(stderr, "[ERROR] shm_open failed for %s\n", name);
+        return NULL;
+    }
+    if (ftruncate(fd, sizeof(LiveStats)) == -1) {
+        fprintf(stderr, "[ERROR] ftruncate failed for %s\n", name);
+        close(fd);
+        shm_unlink(name);
+        return NULL;
+    }
+    LiveStats *live = mmap(NULL, sizeof(LiveStats), PROT_READ | PROT_WRITE,
+                           MAP_SHARED, fd, 0);
+    close(fd);
+    if (live == MAP_FAILED) {
+        fprintf(stderr, "[ERROR] mmap failed for %s\n", name);
+        shm_unlink(name);
+        return NULL;
+    }
+    memset(live, 0, sizeof(*live));
+    live->version = LIVE_STATS_VERSION;
+    live->pid = getpid();
+    return live;
+}
+
+/**
+ * @brief Unmaps and removes the named stats segment
+ * @param live Pointer to the mapped segment
+ * @param name Name of the segment
+ */
+void live_stats_destroy(LiveStats *live, const char *name) {
+    munmap(live, sizeof(LiveStats));
+    shm_unlink(name);
+}
+
+/**
+ * @brief Copies the simulation counters into the segment
+ * @param live Pointer to the mapped segment
+ * @param shared_data Pointer to the shared data
+ * @param last_actions Action counter of the previous sample, updated
+ *
+ * Reads the shared data without taking its locks, so a sample may be off
+ * by an in-flight event. Only this process writes the segment.
+ */
+void live_stats_sample(LiveStats *live, SharedData *shared_data,
+                       long long *last_actions) {
+    long long now = now_ns();
+    long long actions = shared_data->action_counter - 1;
+    int waiting[2];
+
+    __atomic_store_n(&live->seq, live->seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    if (live->updated_ns > 0 && now > live->updated_ns) {
+        live->action_rate = (double)(actions - *last_actions) * NS_PER_SEC /
+                            (now - live->updated_ns);
+    }
+    *last_actions = actions;
+    live->start_ns = shared_data->start_ns;
+    live->updated_ns = now;
+    live->capacity = shared_data->ferry_capacity;
+    live->expected = shared_data->expected_vehicles;
+    live->unloaded = shared_data->total_vehicles_unloaded;
+    live->actions = actions;
+    live->trips = shared_data->ferry_cycles;
+    live->ferry_port = shared_data->ferry_port;
+    live->deck_vehicles = deck_vehicles(shared_data);
+    live->deck_units = deck_units(shared_data);
+    live->classes = shared_data->classes.count;
+    for (int cls = 0; cls < live->classes; cls++) {
+        const VehicleClass *vehicle_class = &shared_data->classes.classes[cls];
+        live->class_letter[cls] = vehicle_class->letter;
+        memcpy(live->class_name[cls], vehicle_class->name, CLASS_NAME_LEN);
+        live->waiting[cls][0] = shared_data->waiting[cls][0];
+        live->waiting[cls][1] = shared_data->waiting[cls][1];
+    }
+    for (int port = 0; port < 2; port++) {
+        waiting[port] = port_waiting(shared_data, port);
+    }
+    live->queue_history[live->history_head][0] = waiting[0];
+    live->queue_history[live->history_head][1] = waiting[1];
+    live->history_head = (live->history_head + 1) % LIVE_HISTORY;
+    if (live->history_len < LIVE_HISTORY) {
+        live->history_len++;
+    }
+    live->finished = __atomic_load_n(&shared_data->finished, __ATOMIC_ACQUIRE);
+
+    __atomic_store_n(&live->seq, live->seq + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Main function for the stats publisher process
+ * @param shared_data Pointer to the shared data
+ * @param cfg Configuration structure
+ * @param live Pointer to the mapped segment
+ *
+ * Samples every --live-ms until the ferry finishes or the run is aborted,
+ * then publishes a last sample.
+ */
+void publisher_process(SharedData *shared_data, Config cfg, LiveStats *live) {
+    long long interval_ns = cfg.live_ms * NS_PER_MS;
+    struct timespec tick = {interval_ns / NS_PER_SEC, interval_ns % NS_PER_SEC};
+    long long last_actions = 0;
+
+    while (!run_over(shared_data)) {
+        live_stats_sample(live, shared_data, &last_actions);
+        futex_wait(&shared_data->finished, 0, &tick);
+    }
+    live_stats_sample(live, shared_data, &last_actions);
+}
+
+/**
+ * @brief Creates the stats publisher process
+ * @param shared_data Pointer to the shared data
+ * @param cfg Configuration structure
+ * @param live Pointer to the mapped segment
+ * @return PID of the publisher process
+ */
+pid_t create_publisher_process(SharedData *shared_data, Config cfg,
+                               LiveStats *live) {
+    pid_t publisher_pid = fork();
+    if (publisher_pid == 0) {
+        apply_helper_placement(cfg);
+        publisher_process(shared_data, cfg, live);
+        _exit(EXIT_SUCCESS);
+    } else if (publisher_pid < 0) {
+        fprintf(stderr, "[ERROR] fork failed\n");
+        exit(EXIT_FAILURE);
+    }
+    return publisher_pid;
+}
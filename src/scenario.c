@@ -0,0 +1,238 @@
+#include "main.h"
+
+// --- Parsing ---
+#define SCENARIO_LINE_LEN 256
+#define SCENARIO_DELIMS " \t\r\n"
+
+// --- Segment kinds, indexed by SegmentKind ---
+static const char *SEGMENT_KINDS[] = {"backlog", "even", "poisson", "burst"};
+
+/**
+ * @brief Parses the optional "name=value" fields of a segment
+ * @param field The field
+ * @param seg Segment to fill
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ */
+static int parse_segment_option(char *field, ScenarioSegment *seg) {
+    char *value = strchr(field, '=');
+    if (value == NULL) {
+        fprintf(stderr, "[ERROR] Expected name=value, got %s\n", field);
+        return EXIT_FAILURE;
+    }
+    *value++ = '\0';
+    if (strcmp(field, "port1") == 0) {
+        return parse_uint(value, 0, 100, "port1", &seg->port1_pct);
+    }
+    if (strcmp(field, "size") == 0 && seg->kind == SEGMENT_BURST) {
+        return parse_uint(value, 1, MAX_NUM_CARS + MAX_NUM_TRUCKS, "size",
+                          &seg->burst_size);
+    }
+    if (strcmp(field, "ramp") == 0 && seg->kind == SEGMENT_POISSON) {
+        char *to = strchr(value, ':');
+        if (to == NULL) {
+            fprintf(stderr, "[ERROR] Expected ramp=FROM:TO, got %s\n", value);
+            return EXIT_FAILURE;
+        }
+        *to++ = '\0';
+        if (parse_uint(value, 0, MAX_SCENARIO_RAMP, "ramp", &seg->ramp_from) ||
+            parse_uint(to, 0, MAX_SCENARIO_RAMP, "ramp", &seg->ramp_to)) {
+            return EXIT_FAILURE;
+        }
+        if (seg->ramp_from == 0 && seg->ramp_to == 0) {
+            fprintf(stderr, "[ERROR] A ramp needs a nonzero rate\n");
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+    fprintf(stderr, "[ERROR] Option %s does not apply to %s\n", field,
+            SEGMENT_KINDS[seg->kind]);
+    return EXIT_FAILURE;
+}
+
+/**
+ * @brief Parses one segment line
+ * @param line The line, modified in place
+ * @param seg Segment to fill
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ */
+static int parse_segment(char *line, ScenarioSegment *seg) {
+    char *save;
+    char *kind = strtok_r(line, SCENARIO_DELIMS, &save);
+    seg->kind = -1;
+    for (size_t i = 0; i < sizeof(SEGMENT_KINDS) / sizeof(SEGMENT_KINDS[0]);
+         i++) {
+        if (strcmp(kind, SEGMENT_KINDS[i]) == 0) {
+            seg->kind = i;
+        }
+    }
+    if ((int)seg->kind == -1) {
+        fprintf(stderr, "[ERROR] Unknown segment kind %s\n", kind);
+        return EXIT_FAILURE;
+    }
+
+    const char *names[] = {"start_us", "end_us", "cars", "trucks"};
+    int maxes[] = {MAX_SCENARIO_US, MAX_SCENARIO_US, MAX_NUM_CARS,
+                   MAX_NUM_TRUCKS};
+    int *fields[] = {&seg->start_us, &seg->end_us, &seg->cars, &seg->trucks};
+    for (int i = 0; i < 4; i++) {
+        char *field = strtok_r(NULL, SCENARIO_DELIMS, &save);
+        if (field == NULL) {
+            fprintf(stderr, "[ERROR] Missing %s\n", names[i]);
+            return EXIT_FAILURE;
+        }
+        if (parse_uint(field, 0, maxes[i], names[i], fields[i])) {
+            return EXIT_FAILURE;
+        }
+    }
+    if (seg->end_us < seg->start_us) {
+        fprintf(stderr, "[ERROR] The segment ends before it starts\n");
+        return EXIT_FAILURE;
+    }
+
+    seg->port1_pct = 50;
+    seg->ramp_from = 1;
+    seg->ramp_to = 1;
+    seg->burst_size = DEFAULT_BURST_SIZE;
+    char *field;
+    while ((field = strtok_r(NULL, SCENARIO_DELIMS, &save)) != NULL) {
+        if (parse_segment_option(field, seg) != EXIT_SUCCESS) {
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Reads a scenario file
+ * @param path Path of the file
+ * @param scenario Scenario to fill
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ */
+int scenario_load(const char *path, Scenario *scenario) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        fprintf(stderr, "[ERROR] Failed to open scenario %s\n", path);
+        return EXIT_FAILURE;
+    }
+    scenario->count = 0;
+    scenario->cars = 0;
+    scenario->trucks = 0;
+
+    char line[SCENARIO_LINE_LEN];
+    int line_no = 0;
+    int result = EXIT_SUCCESS;
+    while (result == EXIT_SUCCESS && fgets(line, sizeof(line), file)) {
+        line_no++;
+        size_t skip = strspn(line, SCENARIO_DELIMS);
+        if (line[skip] == '\0' || line[skip] == '#') {
+            continue;
+        }
+        if (scenario->count == MAX_SCENARIO_SEGMENTS) {
+            fprintf(stderr, "[ERROR] More than %d segments\n",
+                    MAX_SCENARIO_SEGMENTS);
+            result = EXIT_FAILURE;
+        } else {
+            ScenarioSegment *seg = &scenario->segments[scenario->count++];
+            result = parse_segment(line, seg);
+            scenario->cars += seg->cars;
+            scenario->trucks += seg->trucks;
+        }
+        if (result == EXIT_SUCCESS && (scenario->cars > MAX_NUM_CARS ||
+                                       scenario->trucks > MAX_NUM_TRUCKS)) {
+            fprintf(stderr, "[ERROR] More than %d cars or %d trucks\n",
+                    MAX_NUM_CARS, MAX_NUM_TRUCKS);
+            result = EXIT_FAILURE;
+        }
+        if (result != EXIT_SUCCESS) {
+            fprintf(stderr, "[ERROR] In scenario %s, line %d\n", path,
+                    line_no);
+        }
+    }
+    fclose(file);
+    if (result == EXIT_SUCCESS && scenario->count == 0) {
+        fprintf(stderr, "[ERROR] Scenario %s has no segments\n", path);
+        result = EXIT_FAILURE;
+    }
+    return result;
+}
+
+/**
+ * @brief Draws a point of [0, 1) from the rising or falling rate of a ramp
+ * @param state State of the random stream
+ * @param from Relative rate at 0
+ * @param to Relative rate at 1
+ * @return The point
+ *
+ * Rejection sampling: a uniform point is kept with probability rate / peak,
+ * so the arrivals follow a Poisson process whose rate changes linearly.
+ */
+static double draw_ramp(unsigned int *state, int from, int to) {
+    int peak = from > to ? from : to;
+    for (;;) {
+        double x = rand_r(state) / (RAND_MAX + 1.0);
+        double keep = rand_r(state) / (RAND_MAX + 1.0) * peak;
+        if (keep < from + (to - from) * x) {
+            return x;
+        }
+    }
+}
+
+/**
+ * @brief Arrival time of the k-th of n vehicles of a segment
+ * @param seg The segment
+ * @param k Position of the vehicle in the segment
+ * @param n Vehicles of the segment
+ * @param state State of the random stream
+ * @return Arrival time after the start in ns
+ */
+static long long segment_due_ns(const ScenarioSegment *seg, int k, int n,
+                                unsigned int *state) {
+    long long span = seg->end_us - seg->start_us;
+    long long offset = 0;
+    switch (seg->kind) {
+    case SEGMENT_BACKLOG:
+        break;
+    case SEGMENT_EVEN:
+        offset = span * k / n;
+        break;
+    case SEGMENT_POISSON:
+        return seg->start_us * NS_PER_US +
+               (long long)(draw_ramp(state, seg->ramp_from, seg->ramp_to) * span *
+                           NS_PER_US);
+    case SEGMENT_BURST: {
+        int bursts = (n + seg->burst_size - 1) / seg->burst_size;
+        offset = span * (k / seg->burst_size) / bursts;
+        break;
+    }
+    }
+    return (seg->start_us + offset) * NS_PER_US;
+}
+
+/**
+ * @brief Draws the arrivals of every scenario vehicle
+ * @param scenario The scenario
+ * @param due_ns Arrival time after the start of each vehicle index
+ * @param port Port of each vehicle index
+ * @param state State of the random stream
+ *
+ * Vehicle indexes count cars first, then trucks, like the arrival schedule.
+ * Within a segment the cars and trucks are interleaved at random, so a
+ * segment of evenly spaced arrivals does not end with all of its trucks.
+ */
+void scenario_draw(const Scenario *scenario, long long *due_ns, int *port,
+                   unsigned int *state) {
+    int next_car = 0;
+    int next_truck = scenario->cars;
+    for (int i = 0; i < scenario->count; i++) {
+        const ScenarioSegment *seg = &scenario->segments[i];
+        int n = seg->cars + seg->trucks;
+        int trucks_left = seg->trucks;
+        for (int k = 0; k < n; k++) {
+            int is_truck = rand_r(state) % (n - k) < trucks_left;
+            int vehicle = is_truck ? next_truck++ : next_car++;
+            trucks_left -= is_truck;
+            due_ns[vehicle] = segment_due_ns(seg, k, n, state);
+            port[vehicle] = rand_r(state) % 100 < seg->port1_pct;
+        }
+    }
+}
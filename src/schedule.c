@@ -0,0 +1,151 @@
+#include "schedule.h"
+
+#include <stdio.h>     // fprintf
+#include <stdlib.h>    // qsort
+#include <sys/mman.h>  // mmap
+
+#include "adaptive_wait.h"
+
+// --- Every array of the mapping starts 8-byte aligned ---
+#define SCHEDULE_ALIGN(size) (((size) + 7) & ~(size_t)7)
+
+// --- Structs ---
+typedef struct {
+    long long due_ns;
+    int vehicle;
+    int port;
+} ScheduleEntry;
+
+/**
+ * @brief Carves an array out of the schedule mapping
+ * @param next Next free byte, advanced past the array
+ * @param size Size of the array
+ * @return Start of the array
+ */
+static void *carve(char **next, size_t size) {
+    void *array = *next;
+    *next += SCHEDULE_ALIGN(size);
+    return array;
+}
+
+/**
+ * @brief Maps an empty schedule in shared memory
+ * @param count Vehicles of the batch
+ * @return The schedule, or NULL on failure
+ *
+ * The caller fills due_ns, vehicle and port of every slot and then calls
+ * schedule_sort().
+ */
+ArrivalSchedule *schedule_create(int count) {
+    size_t len = SCHEDULE_ALIGN(sizeof(ArrivalSchedule)) +
+                 SCHEDULE_ALIGN(count * sizeof(long long)) +
+                 4 * SCHEDULE_ALIGN(count * sizeof(int));
+    ArrivalSchedule *schedule = mmap(NULL, len, PROT_READ | PROT_WRITE,
+                                     MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (schedule == MAP_FAILED) {
+        fprintf(stderr, "[ERROR] mmap failed for the arrival schedule\n");
+        return NULL;
+    }
+    char *next = (char *)schedule;
+    carve(&next, sizeof(ArrivalSchedule));
+    schedule->count = count;
+    schedule->due_ns = carve(&next, count * sizeof(long long));
+    schedule->vehicle = carve(&next, count * sizeof(int));
+    schedule->port = carve(&next, count * sizeof(int));
+    schedule->state = carve(&next, count * sizeof(int));
+    schedule->slot_of = carve(&next, count * sizeof(int));
+    schedule->map_len = len;
+    return schedule;
+}
+
+/**
+ * @brief Orders entries by due time, then by vehicle index
+ */
+static int compare_entries(const void *a, const void *b) {
+    const ScheduleEntry *x = a;
+    const ScheduleEntry *y = b;
+    if (x->due_ns != y->due_ns) {
+        return x->due_ns < y->due_ns ? -1 : 1;
+    }
+    return x->vehicle - y->vehicle;
+}
+
+/**
+ * @brief Sorts the filled slots by due time and indexes them by vehicle
+ * @param schedule The schedule
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ */
+int schedule_sort(ArrivalSchedule *schedule) {
+    ScheduleEntry *entries = malloc(schedule->count * sizeof(*entries));
+    if (entries == NULL) {
+        fprintf(stderr, "[ERROR] Out of memory\n");
+        return EXIT_FAILURE;
+    }
+    for (int slot = 0; slot < schedule->count; slot++) {
+        entries[slot].due_ns = schedule->due_ns[slot];
+        entries[slot].vehicle = schedule->vehicle[slot];
+        entries[slot].port = schedule->port[slot];
+    }
+    qsort(entries, schedule->count, sizeof(*entries), compare_entries);
+    for (int slot = 0; slot < schedule->count; slot++) {
+        schedule->due_ns[slot] = entries[slot].due_ns;
+        schedule->vehicle[slot] = entries[slot].vehicle;
+        schedule->port[slot] = entries[slot].port;
+        schedule->state[slot] = SLOT_PENDING;
+        schedule->slot_of[entries[slot].vehicle] = slot;
+    }
+    free(entries);
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Looks up the slot of a vehicle
+ * @param schedule The schedule
+ * @param vehicle Vehicle index, -1 for a vehicle outside the batch
+ * @return The slot, or -1 for a vehicle outside the batch
+ */
+int schedule_slot(const ArrivalSchedule *schedule, int vehicle) {
+    if (vehicle < 0 || vehicle >= schedule->count) {
+        return -1;
+    }
+    return schedule->slot_of[vehicle];
+}
+
+/**
+ * @brief Sleeps until the dispatcher released the slot
+ * @param schedule The schedule
+ * @param slot Slot of the calling vehicle
+ */
+void schedule_wait(ArrivalSchedule *schedule, int slot) {
+    int *state = &schedule->state[slot];
+    int expected = SLOT_PENDING;
+    // Announce the sleeper, unless the slot was released already
+    __atomic_compare_exchange_n(state, &expected, SLOT_WAITING, 0,
+                                __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+    while (__atomic_load_n(state, __ATOMIC_ACQUIRE) != SLOT_RELEASED) {
+        futex_wait(state, SLOT_WAITING, NULL);
+    }
+}
+
+/**
+ * @brief Releases a slot, waking its vehicle only if it sleeps
+ * @param schedule The schedule
+ * @param slot The slot
+ */
+void schedule_release(ArrivalSchedule *schedule, int slot) {
+    int *state = &schedule->state[slot];
+    if (__atomic_exchange_n(state, SLOT_RELEASED, __ATOMIC_ACQ_REL) ==
+        SLOT_WAITING) {
+        futex_wake(state, 1);
+    }
+}
+
+/**
+ * @brief Unmaps the schedule
+ * @param schedule The schedule, may be NULL
+ */
+void schedule_destroy(ArrivalSchedule *schedule) {
+    if (schedule != NULL) {
+        munmap(schedule, schedule->map_len);
+    }
+}
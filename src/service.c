@@ -0,0 +1,236 @@
+#include "service.h"
+
+#include <errno.h>  // errno
+#include <fcntl.h>  // open
+#include <limits.h> // INT_MAX
+#include <poll.h>   // poll
+
+/**
+ * @brief Starts a new reporting interval
+ * @param report Report state
+ * @param shared_data Pointer to the shared data
+ */
+void progress_init(ProgressReport *report, SharedData *shared_data) {
+    report->last_ns = now_ns();
+    report->last_unloaded = shared_data->total_vehicles_unloaded;
+    report->last_actions = shared_data->action_counter;
+    report->last_latency_ns = shared_data->latency_ns_total;
+    report->last_latency_count = shared_data->latency_count;
+}
+
+/**
+ * @brief Prints throughput and latency since the previous report
+ * @param report Report state
+ * @param shared_data Pointer to the shared data
+ * @param out Output stream
+ *
+ * Counters are read without locks, a report may be off by an event.
+ */
+void progress_report(ProgressReport *report, SharedData *shared_data,
+                     FILE *out) {
+    long long now = now_ns();
+    long long unloaded = shared_data->total_vehicles_unloaded;
+    long long actions = shared_data->action_counter;
+    long long latency_ns = shared_data->latency_ns_total;
+    long long latency_count = shared_data->latency_count;
+    double seconds = (double)(now - report->last_ns) / NS_PER_SEC;
+    long long interval_count = latency_count - report->last_latency_count;
+
+    fprintf(out,
+            "[REPORT] t=%.1fs unloaded=%lld (%.1f/s) actions=%lld (%.1f/s) "
+            "waiting=%d/%d",
+            (double)(now - shared_data->start_ns) / NS_PER_SEC, unloaded,
+            (unloaded - report->last_unloaded) / seconds, actions - 1,
+            (actions - report->last_actions) / seconds,
+            port_waiting(shared_data, 0), port_waiting(shared_data, 1));
+    if (interval_count > 0) {
+        fprintf(out, " latency=%.3fms",
+                (double)(latency_ns - report->last_latency_ns) /
+                    interval_count / NS_PER_MS);
+    }
+    fprintf(out, "\n");
+    fflush(out);
+
+    report->last_ns = now;
+    report->last_unloaded = unloaded;
+    report->last_actions = actions;
+    report->last_latency_ns = latency_ns;
+    report->last_latency_count = latency_count;
+}
+
+/**
+ * @brief Handles one arrival request such as "O", "N 1" or "O 0"
+ * @param shared_data Pointer to the shared data
+ * @param cfg Configuration structure
+ * @param line The request without the newline, the letter of any class
+ * @param next_id Last used id per class, updated on success
+ * @return 1 if a vehicle was spawned, 0 otherwise
+ *
+ * The optional number is the port, a random one is used without it.
+ * Empty lines and lines starting with '#' are ignored. Ids keep counting
+ * past MAX_CLASS_VEHICLES, the vehicle table just stops tracking them.
+ */
+int handle_stream_line(SharedData *shared_data, Config cfg, char *line,
+                       int next_id[MAX_VEHICLE_CLASSES]) {
+    char vehicle_type;
+    int port = -1;
+    int fields = sscanf(line, " %c %d", &vehicle_type, &port);
+
+    if (fields < 1 || vehicle_type == '#') {
+        return 0;
+    }
+    int cls = class_find(&cfg.classes, vehicle_type);
+    if (cls == CLASS_NONE || (fields == 2 && port != 0 && port != 1)) {
+        fprintf(stderr, "[WARNING] Ignoring arrival request \"%s\"\n", line);
+        return 0;
+    }
+    // Ids past the vehicle table are fine, those vehicles are not tracked
+    if (next_id[cls] == INT_MAX) {
+        fprintf(stderr, "[WARNING] No more ids for %s\n", line);
+        return 0;
+    }
+    spawn_vehicle(shared_data, cfg, cls, ++next_id[cls], port);
+    return 1;
+}
+
+/**
+ * @brief Helper function to publish the final number of vehicles
+ * @param shared_data Pointer to the shared data
+ * @param total Number of crossings of the vehicles spawned in the run
+ */
+static void set_expected_vehicles(SharedData *shared_data, long long total) {
+    sync_wait(&shared_data->lock_mutex);
+    shared_data->expected_vehicles = total;
+    // A parked ferry checks whether the run is over
+    notify_arrival(shared_data);
+    sync_post(&shared_data->lock_mutex);
+}
+
+/**
+ * @brief Helper function to compute the poll timeout until the next report
+ * @return Timeout in milliseconds, -1 to wait without a timeout
+ */
+static int report_timeout_ms(ProgressReport *report, Config cfg) {
+    if (cfg.report_ms == 0) {
+        return -1;
+    }
+    long long due = report->last_ns + cfg.report_ms * NS_PER_MS;
+    long long left_ms = (due - now_ns()) / NS_PER_MS;
+    return left_ms > 0 ? (int)left_ms : 0;
+}
+
+/**
+ * @brief Spawns vehicles for arrival requests until the stream ends
+ * @param shared_data Pointer to the shared data
+ * @param cfg Configuration structure
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ *
+ * Streamed vehicles arrive immediately and get ids following the initial
+ * batch. Once the stream ends the ferry learns the final number of
+ * vehicles and finishes after unloading all of them. A FIFO must be kept
+ * open by a writer for as long as the service should run.
+ */
+int stream_arrivals(SharedData *shared_data, Config cfg) {
+    long long spawned = cfg.classes.vehicles;
+    int fd = strcmp(cfg.stream_path, "-") == 0
+                 ? STDIN_FILENO
+                 : open(cfg.stream_path, O_RDONLY);
+    if (fd == -1) {
+        fprintf(stderr, "[ERROR] Failed to open arrival stream %s\n",
+                cfg.stream_path);
+        set_expected_vehicles(shared_data, spawned * cfg.crossings);
+        return EXIT_FAILURE;
+    }
+
+    // Streamed vehicles arrive immediately
+    Config vehicle_cfg = cfg;
+    int next_id[MAX_VEHICLE_CLASSES];
+    for (int cls = 0; cls < cfg.classes.count; cls++) {
+        vehicle_cfg.classes.classes[cls].max_arrival_us = 0;
+        next_id[cls] = cfg.classes.classes[cls].count;
+    }
+    char buf[STREAM_BUFFER_LEN];
+    size_t used = 0;
+    ProgressReport report;
+    progress_init(&report, shared_data);
+
+    while (1) {
+        struct pollfd pfd = {.fd = fd, .events = POLLIN};
+        int ready = poll(&pfd, 1, report_timeout_ms(&report, cfg));
+        if (cfg.report_ms > 0 && report_timeout_ms(&report, cfg) == 0) {
+            progress_report(&report, shared_data, stderr);
+        }
+        // Reap vehicles that already crossed
+        pid_t reaped;
+        while ((reaped = waitpid(-1, NULL, WNOHANG)) > 0) {
+            reap_child(shared_data, reaped);
+        }
+        if (run_over(shared_data) || (ready < 0 && errno != EINTR)) {
+            break;
+        }
+        if (ready <= 0) {
+            continue;
+        }
+
+        ssize_t len = read(fd, buf + used, sizeof(buf) - used);
+        if (len <= 0) {
+            break;
+        }
+        used += len;
+        char *start = buf;
+        char *newline;
+        while ((newline = memchr(start, '\n', buf + used - start)) != NULL) {
+            *newline = '\0';
+            spawned += handle_stream_line(shared_data, vehicle_cfg, start,
+                                          next_id);
+            start = newline + 1;
+        }
+        used -= start - buf;
+        memmove(buf, start, used);
+        if (used == sizeof(buf)) {
+            fprintf(stderr, "[WARNING] Dropping overlong arrival request\n");
+            used = 0;
+        }
+    }
+    // A last request without a newline
+    if (used > 0 && used < sizeof(buf)) {
+        buf[used] = '\0';
+        spawned += handle_stream_line(shared_data, vehicle_cfg, buf, next_id);
+    }
+
+    if (fd != STDIN_FILENO) {
+        close(fd);
+    }
+    set_expected_vehicles(shared_data, spawned * cfg.crossings);
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Waits for all child processes, reporting progress periodically
+ * @param shared_data Pointer to the shared data
+ * @param cfg Configuration structure
+ */
+void wait_with_reports(SharedData *shared_data, Config cfg) {
+    if (cfg.report_ms == 0) {
+        wait_for_children(shared_data);
+        return;
+    }
+    ProgressReport report;
+    progress_init(&report, shared_data);
+    struct timespec interval = {cfg.report_ms / 1000,
+                                (cfg.report_ms % 1000) * NS_PER_MS};
+
+    while (!run_over(shared_data)) {
+        futex_wait(&shared_data->finished, 0, &interval);
+        progress_report(&report, shared_data, stderr);
+        // Stop reporting if the simulation died without finishing
+        pid_t reaped;
+        while ((reaped = waitpid(-1, NULL, WNOHANG)) > 0) {
+            reap_child(shared_data, reaped);
+        }
+        if (reaped == -1) {
+            return;
+        }
+    }
+    wait_for_children(shared_data);
+}
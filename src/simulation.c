@@ -0,0 +1,1855 @@
+#include "ferry.h"
+
+#include <signal.h>  // kill
+
+#include "checker.h"
+#include "dispatcher.h"
+#include "port_server.h"
+#include "publisher.h"
+#include "service.h"
+#include "watchdog.h"
+
+/**
+ * @brief Helper function to initialize a semaphore
+ * @param sem Pointer to the semaphore
+ * @param pshared Whether the semaphore is shared between processes (1 = shared)
+ * @param init_value Initial value of the semaphore
+ * @param sem_name Name of the semaphore for error messages
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ */
+int init_semaphore(sem_t *sem, int pshared, unsigned int init_value,
+                   const char *sem_name) {
+    if (sem_init(sem, pshared, init_value) == -1) {
+        fprintf(stderr, "[ERROR] sem_init failed for %s\n", sem_name);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+// --- Semaphores of the shared data ---
+#define SHARED_SEMAPHORES (5 + MAX_DECK_SLOTS + 2 * MAX_VEHICLE_CLASSES)
+
+typedef struct {
+    sem_t *sem;
+    unsigned int value;  // Initial value
+    const char *name;    // Name for error messages
+} SemaphoreSpec;
+
+/**
+ * @brief Helper function to list every semaphore of the shared data
+ * @param shared_data Pointer to the shared data
+ * @param queue_limit Places in the queue of a port, 0 without a limit
+ * @param specs Filled with SHARED_SEMAPHORES entries
+ *
+ * The order is the order of initialization, so a failed initialization
+ * destroys exactly the ones before it.
+ */
+static void list_semaphores(SharedData *shared_data, int queue_limit,
+                            SemaphoreSpec specs[SHARED_SEMAPHORES]) {
+    int count = 0;
+    specs[count++] = (SemaphoreSpec){&shared_data->action_counter_sem, 1,
+                                     "action_counter_sem"};
+    specs[count++] = (SemaphoreSpec){&shared_data->lock_mutex, 1, "lock_mutex"};
+    specs[count++] = (SemaphoreSpec){&shared_data->unload_complete_sem, 0,
+                                     "unload_complete_sem"};
+    for (int port = 0; port < 2; port++) {
+        specs[count++] = (SemaphoreSpec){&shared_data->admit_sem[port],
+                                         queue_limit, "admit_sem"};
+    }
+    for (int slot = 0; slot < MAX_DECK_SLOTS; slot++) {
+        specs[count++] =
+            (SemaphoreSpec){&shared_data->slot_sem[slot], 0, "slot_sem"};
+    }
+    for (int cls = 0; cls < MAX_VEHICLE_CLASSES; cls++) {
+        for (int port = 0; port < 2; port++) {
+            specs[count++] = (SemaphoreSpec){&shared_data->load_sem[cls][port],
+                                             0, "load_sem"};
+        }
+    }
+}
+
+/**
+ * @brief Function to initialize shared data
+ * @param cfg Configuration structure
+ * @return Pointer to initialized SharedData, or NULL on failure
+ *
+ * Initializes shared data using mmap and semaphores. On failure everything
+ * set up so far is released again.
+ */
+SharedData *init_shared_data(Config cfg) {
+    // Allocate shared memory using mmap
+    SharedData *shared_data =
+        mmap(NULL, sizeof(SharedData), PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_ANONYMOUS, 0, 0);
+    if (shared_data == MAP_FAILED) {
+        fprintf(stderr, "[ERROR] mmap failed\n");
+        return NULL;
+    }
+    // Place the pages before anything touches them
+    if (cfg.numa_node != PLACEMENT_UNSET) {
+        bind_to_numa_node(shared_data, sizeof(SharedData), cfg.numa_node);
+    }
+
+    // Initialize semaphores
+    SemaphoreSpec sems[SHARED_SEMAPHORES];
+    list_semaphores(shared_data, cfg.queue_limit, sems);
+    int ready = 0;
+    for (; ready < SHARED_SEMAPHORES; ready++) {
+        if (init_semaphore(sems[ready].sem, 1, sems[ready].value,
+                           sems[ready].name)) {
+            goto unwind;
+        }
+    }
+    shared_data->classes = cfg.classes;
+    // Streamed vehicles get the ids after the batch
+    shared_data->vehicles =
+        vehicle_table_create(&cfg.classes, cfg.stream_path != NULL);
+    if (shared_data->vehicles == NULL) {
+        goto unwind;
+    }
+    shared_data->check_failed = 0;
+    shared_data->events = NULL;
+    if (cfg.check && (shared_data->events = event_ring_create()) == NULL) {
+        goto unwind;
+    }
+    shared_data->schedule = NULL;
+    if ((cfg.dispatch || cfg.scenario.count > 0) &&
+        cfg.classes.vehicles > 0 &&
+        (shared_data->schedule = schedule_build(cfg)) == NULL) {
+        goto unwind;
+    }
+    // Short handoffs between ferry and vehicles
+    adaptive_sem_init(&shared_data->vehicle_boarding, 1, cfg.spin_max);
+    adaptive_sem_init(&shared_data->loading_done, 0, cfg.spin_max);
+
+    // Initialize shared data
+    shared_data->action_counter = 1;
+    shared_data->ferry_port = 0;
+    shared_data->ferry_capacity = cfg.capacity_of_ferry;
+    for (int cls = 0; cls < MAX_VEHICLE_CLASSES; cls++) {
+        shared_data->waiting[cls][0] = 0;
+        shared_data->waiting[cls][1] = 0;
+        shared_data->loaded[cls] = 0;
+    }
+    boarding_init(&shared_data->boarding, cfg.boarding_policy, &cfg.classes);
+    deck_init(&shared_data->deck, cfg.unload_order, cfg.deck_lanes);
+    shared_data->arrival_seq = 0;
+    shared_data->ferry_holding = 0;
+    shared_data->ferry_idle = 0;
+    shared_data->peak_waiting[0] = 0;
+    shared_data->peak_waiting[1] = 0;
+    shared_data->queue_limit = cfg.queue_limit;
+    for (int port = 0; port < 2; port++) {
+        shared_data->refused[port] = 0;
+        shared_data->refused_ns[port] = 0;
+    }
+    shared_data->refused_ns_max = 0;
+    shared_data->idle_parks = 0;
+    shared_data->arrived_vehicles = 0;
+    for (int port = 0; port < 2; port++) {
+        shared_data->last_arrival_ns[port] = 0;
+        shared_data->arrival_gap_ns[port] = 0;
+    }
+    shared_data->departure_rule = cfg.departure_rule;
+    shared_data->departure_holds = 0;
+    shared_data->held_vehicles = 0;
+    shared_data->total_vehicles_unloaded = 0;
+    shared_data->crossings = cfg.crossings;
+    // Unknown until the arrival stream ends
+    shared_data->expected_vehicles =
+        cfg.stream_path ? -1 : (long long)cfg.classes.vehicles * cfg.crossings;
+    shared_data->latency_ns_total = 0;
+    shared_data->latency_count = 0;
+    shared_data->start_ns = now_ns();
+    shared_data->end_ns = 0;
+    for (int cls = 0; cls < MAX_VEHICLE_CLASSES; cls++) {
+        for (int port = 0; port < 2; port++) {
+            histogram_init(&shared_data->wait_hist[cls][port]);
+            histogram_init(&shared_data->transit_hist[cls][port]);
+        }
+    }
+    for (int kind = 0; kind < SLEEP_KINDS; kind++) {
+        histogram_init(&shared_data->overshoot[kind]);
+    }
+    shared_data->port_link = cfg.port_link;
+    for (int port = 0; port < 2; port++) {
+        shared_data->port_messages[port] = 0;
+        histogram_init(&shared_data->port_rtt[port]);
+    }
+    shared_data->worst_wait_ns = -1;
+    shared_data->ferry_cycles = 0;
+    shared_data->cycle_ns_total = 0;
+    shared_data->cycle_ns_min = 0;
+    shared_data->cycle_ns_max = 0;
+    shared_data->ferry_cpu_ns = 0;
+    shared_data->finished = 0;
+    shared_data->stalled = 0;
+    shared_data->aborted = 0;
+    shared_data->ferry_pid = 0;
+    shared_data->sim_pgid = 0;
+    shared_data->keep_events = cfg.watchdog_ms > 0;
+
+    return shared_data;
+
+unwind:
+    // The mapping is zeroed, so the tables not created yet are NULL
+    for (int i = ready - 1; i >= 0; i--) {
+        destroy_semaphore(sems[i].sem, sems[i].name);
+    }
+    schedule_destroy(shared_data->schedule);
+    event_ring_destroy(shared_data->events);
+    vehicle_table_destroy(shared_data->vehicles);
+    munmap(shared_data, sizeof(SharedData));
+    return NULL;
+}
+
+// Random state of the calling process, see seed_process(). The global
+// rand() state belongs to whoever embeds the library.
+static unsigned int rand_state = 1;
+
+/**
+ * @brief Generates a random number within a given range inclusive
+ * @param state State of the random stream, advanced by the draw
+ * @param min Lower bound of the range
+ * @param max Upper bound of the range
+ * @return A random int in the range (min , max)
+ */
+int rand_range_r(unsigned int *state, int min, int max) {
+    return min + rand_r(state) / (RAND_MAX / (max - min + 1) + 1);
+}
+
+/**
+ * @brief Generates a random number within a given range inclusive
+ * @param min Lower bound of the range
+ * @param max Upper bound of the range
+ * @return A random int in the range (min , max), from the stream of the
+ * calling process
+ */
+int rand_range(int min, int max) {
+    return rand_range_r(&rand_state, min, max);
+}
+
+/**
+ * @brief Logs an action performed by a vehicle or ferry to the log sink.
+ * @param shared_data Pointer to the shared data.
+ * @param log Sink where actions are recorded.
+ * @param vehicle_type Character representing the type of vehicle ('O' for car,
+ * 'N' for truck, 'P' for ferry).
+ * @param id ID of the vehicle. Pass 0 for ferry.
+ * @param action Description of the action being logged.
+ * @param port The port number related to the action. If you don't have one,
+ * pass -1.
+ *
+ * This function records an action and its relevant details in the log.
+ * It ensures synchronized access to the action counter using a semaphore.
+ */
+void print_action(SharedData *shared_data, const FerrySink *log,
+                  const char vehicle_type, int id, const char *action,
+                  int port) {
+    char line[EVENT_LINE_LEN];
+    sync_wait(&shared_data->action_counter_sem);
+
+    long long number = shared_data->action_counter++;
+    int len = snprintf(line, sizeof(line), "%lld: ", number);
+    // If id is 0, it's a ferry
+    if (id == 0) {
+        len += snprintf(line + len, sizeof(line) - len, "%c: %s",
+                        vehicle_type, action);
+    } else {
+        len += snprintf(line + len, sizeof(line) - len, "%c %d: %s",
+                        vehicle_type, id, action);
+    }
+    // If port is not -1, print it
+    if (port != -1) {
+        len += snprintf(line + len, sizeof(line) - len, " %d", port);
+    }
+    sink_write(log, line, len < (int)sizeof(line) ? (size_t)len : sizeof(line) - 1);
+    if (shared_data->events != NULL) {
+        publish_event(shared_data, number, vehicle_type, id, action, port);
+    }
+    // Keep the line for stall dumps
+    if (shared_data->keep_events) {
+        memcpy(shared_data->recent_events[number % EVENT_HISTORY], line,
+               sizeof(line));
+    }
+    sync_post(&shared_data->action_counter_sem);
+}
+
+/**
+ * @brief Unloads vehicles from the ferry.
+ * @param shared_data Pointer to the shared data.
+ * @param cfg Configuration parameters.
+ * @return The number of vehicles unloaded.
+ *
+ * This function unloads vehicles from the ferry and returns the number of
+ * vehicles unloaded. It also updates shared data and the total number of
+ * vehicles unloaded. Only the first vehicle of the unload order is woken,
+ * every leaving vehicle wakes the slot after its own.
+ */
+int unload_vehicles(SharedData *shared_data) {
+    // Update shared data and calculate vehicles to unload
+    sync_wait(&shared_data->lock_mutex);
+    int vehicles_to_unload = deck_vehicles(shared_data);
+    shared_data->vehicles_to_unload = vehicles_to_unload;
+    shared_data->vehicles_unloaded = 0;
+    shared_data->total_vehicles_unloaded += vehicles_to_unload;
+    int first = deck_plan_unload(&shared_data->deck);
+    sync_post(&shared_data->lock_mutex);
+
+    if (first != DECK_NONE) {
+        sync_post(&shared_data->slot_sem[first]);
+    }
+    return vehicles_to_unload;
+}
+
+/**
+ * @brief Helper function to try to load a vehicle from the port onto the ferry.
+ * @param shared_data Pointer to shared data.
+ * @param port The port to load the vehicle from.
+ * @param cls The class of the vehicle.
+ * @param remaining_capacity Pointer to the remaining capacity of the ferry.
+ * @param vehicle_count Pointer to the number of vehicles currently loaded.
+ * @return 1 if the vehicle was loaded, 0 otherwise.
+ *
+ * This function tries to load a vehicle from the given port onto the ferry.
+ * It checks if there are vehicles waiting at the port and if the ferry has
+ * enough capacity to load the vehicle. If so, it reduces the waiting count
+ * at the port and the remaining capacity of the ferry, and signals the
+ * vehicle to board the ferry. The function then waits for the vehicle to
+ * finish boarding and increments the vehicle count. If the vehicle is not
+ * loaded, the function returns 0
+ */
+int try_load_vehicle(SharedData *shared_data, int port, int cls,
+                     int *remaining_capacity, int *vehicle_count) {
+    int required_space = shared_data->classes.classes[cls].size;
+    int *waiting = &shared_data->waiting[cls][port];
+
+    if (*waiting > 0 && *remaining_capacity >= required_space) {
+        (*waiting)--;
+        arrival_queue_pop(&shared_data->arrivals[cls][port]);
+        // The place in the queue goes to the next held vehicle
+        if (shared_data->queue_limit > 0) {
+            sync_post(&shared_data->admit_sem[port]);
+        }
+        *remaining_capacity -= required_space;
+        shared_data->vehicles_to_unload++;
+        sync_post(&shared_data->load_sem[cls][port]);
+        sync_handoff_wait(&shared_data->vehicle_boarding);
+        (*vehicle_count)++;
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Returns the deck units taken by the vehicles on board
+ * @param shared_data Pointer to shared data
+ */
+int deck_units(const SharedData *shared_data) {
+    int units = 0;
+    for (int cls = 0; cls < shared_data->classes.count; cls++) {
+        units += shared_data->loaded[cls] * shared_data->classes.classes[cls].size;
+    }
+    return units;
+}
+
+/**
+ * @brief Returns the number of vehicles on board
+ * @param shared_data Pointer to shared data
+ */
+int deck_vehicles(const SharedData *shared_data) {
+    int vehicles = 0;
+    for (int cls = 0; cls < shared_data->classes.count; cls++) {
+        vehicles += shared_data->loaded[cls];
+    }
+    return vehicles;
+}
+
+/**
+ * @brief Returns the number of vehicles waiting at a port
+ * @param shared_data Pointer to shared data
+ * @param port The port
+ */
+int port_waiting(const SharedData *shared_data, int port) {
+    int vehicles = 0;
+    for (int cls = 0; cls < shared_data->classes.count; cls++) {
+        vehicles += shared_data->waiting[cls][port];
+    }
+    return vehicles;
+}
+
+/**
+ * @brief Builds the view of a port that boarding policies decide on
+ * @param shared_data Pointer to shared data, lock_mutex held
+ * @param port Port the ferry is docked at
+ * @param remaining_capacity Free units on the deck
+ * @param view Where to store the view
+ */
+void fill_boarding_view(SharedData *shared_data, int port,
+                        int remaining_capacity, BoardingView *view) {
+    long long now = now_ns();
+    view->classes = shared_data->classes.count;
+    for (int cls = 0; cls < view->classes; cls++) {
+        view->waiting[cls] = shared_data->waiting[cls][port];
+        view->head_ns[cls] =
+            arrival_queue_head(&shared_data->arrivals[cls][port], now);
+    }
+    view->size = shared_data->boarding.size;
+    view->remaining = remaining_capacity;
+}
+
+/**
+ * @brief Calls the vehicles waiting at a port on board
+ * @param shared_data Pointer to shared data
+ * @param port Port the ferry is docked at
+ * @param remaining_capacity Free units on the deck
+ * @return Number of vehicles called
+ *
+ * Calls vehicles in the order chosen by the boarding policy. Run by the
+ * ferry when the ports share the mapping, see port_server.h otherwise.
+ */
+int load_port(SharedData *shared_data, int port, int remaining_capacity) {
+    int vehicle_count = 0;
+    while (remaining_capacity > 0) {
+        BoardingView view;
+        sync_wait(&shared_data->lock_mutex);
+        fill_boarding_view(shared_data, port, remaining_capacity, &view);
+        int cls = boarding_pick(&shared_data->boarding, &view);
+        // No vehicle could be loaded
+        if (cls == BOARDING_NONE) {
+            sync_post(&shared_data->lock_mutex);
+            break;
+        }
+        try_load_vehicle(shared_data, port, cls, &remaining_capacity,
+                         &vehicle_count);
+        sync_post(&shared_data->lock_mutex);
+    }
+
+    return vehicle_count;
+}
+
+/**
+ * @brief Loads vehicles onto the ferry.
+ * @param shared_data Pointer to shared data
+ * @param cfg Configuration struct
+ * @return Number of vehicles called, see wait_for_boarding()
+ *
+ * Loads vehicles in the order chosen by the boarding policy, into the
+ * room left by the vehicles that already boarded at this port
+ */
+int load_ferry(SharedData *shared_data, Config cfg) {
+    sync_wait(&shared_data->lock_mutex);
+    int port = shared_data->ferry_port;
+    int remaining_capacity = cfg.capacity_of_ferry - deck_units(shared_data);
+    sync_post(&shared_data->lock_mutex);
+    if (remaining_capacity <= 0) {
+        return 0;
+    }
+    if (cfg.port_link != PORT_LINK_SHARED) {
+        int called = port_link_load(shared_data, port, remaining_capacity);
+        // Without its port server the run cannot go on
+        if (called == -1) {
+            abort_run(shared_data);
+            return 0;
+        }
+        return called;
+    }
+    return load_port(shared_data, port, remaining_capacity);
+}
+
+/**
+ * @brief Waits until the called vehicles reported on board
+ * @param shared_data Pointer to shared data
+ * @param vehicles Number of vehicles called by load_ferry()
+ */
+void wait_for_boarding(SharedData *shared_data, int vehicles) {
+    // A port server replies once its vehicles are on board
+    if (shared_data->port_link != PORT_LINK_SHARED) {
+        return;
+    }
+    for (int i = 0; i < vehicles; i++) {
+        sync_handoff_wait(&shared_data->loading_done);
+    }
+}
+
+/**
+ * @brief Holds the loaded ferry at a linked port for late arrivals
+ * @param shared_data Pointer to shared data
+ * @param cfg Configuration struct
+ * @param deadline End of the hold
+ *
+ * Asks both servers for their arrivals, since a vehicle may still come to
+ * either, and waits on the server of the port for the next one.
+ */
+static void hold_at_linked_port(SharedData *shared_data, Config cfg,
+                                long long deadline) {
+    int port = shared_data->ferry_port;
+    int held = 0;
+    while (1) {
+        DepartureView view = {.capacity = cfg.capacity_of_ferry,
+                              .deadline = deadline};
+        PortReply status[2];
+        if (port_link_status(shared_data, 0, &status[0]) != EXIT_SUCCESS ||
+            port_link_status(shared_data, 1, &status[1]) != EXIT_SUCCESS) {
+            abort_run(shared_data);
+            return;
+        }
+        sync_wait(&shared_data->lock_mutex);
+        view.deck_units = deck_units(shared_data);
+        sync_post(&shared_data->lock_mutex);
+        view.min_size = shared_data->classes.min_size;
+        view.arrivals_possible = status[0].arrivals + status[1].arrivals <
+                                 shared_data->expected_vehicles;
+        view.arrival_gap_ns = status[port].arrival_gap_ns;
+        view.now = now_ns();
+        int hold = departure_should_hold(cfg.departure_rule, cfg.min_fill,
+                                         &view);
+        shared_data->ferry_holding = hold;
+        shared_data->departure_holds += hold && !held;
+        if (!hold) {
+            return;
+        }
+        held = 1;
+
+        int ports[2] = {port == 0, port == 1};
+        if (port_link_wait(shared_data, ports, deadline) != EXIT_SUCCESS) {
+            abort_run(shared_data);
+            return;
+        }
+        int boarded = load_ferry(shared_data, cfg);
+        shared_data->held_vehicles += boarded;
+    }
+}
+
+/**
+ * @brief Holds the loaded ferry at the port for late arrivals
+ * @param shared_data Pointer to shared data
+ * @param cfg Configuration struct
+ *
+ * Sleeps on the arrival sequence until an arrival or the end of the hold,
+ * boards whoever arrived and asks the departure rule again.
+ */
+void hold_departure(SharedData *shared_data, Config cfg) {
+    if (cfg.departure_rule == DEPART_IMMEDIATE) {
+        return;
+    }
+    long long deadline = now_ns() + cfg.hold_us * NS_PER_US;
+    if (cfg.port_link != PORT_LINK_SHARED) {
+        hold_at_linked_port(shared_data, cfg, deadline);
+        return;
+    }
+    int held = 0;
+    while (1) {
+        DepartureView view = {.capacity = cfg.capacity_of_ferry,
+                              .deadline = deadline};
+        sync_wait(&shared_data->lock_mutex);
+        int port = shared_data->ferry_port;
+        view.deck_units = deck_units(shared_data);
+        view.min_size = shared_data->classes.min_size;
+        view.arrivals_possible =
+            shared_data->expected_vehicles < 0 ||
+            shared_data->arrived_vehicles < shared_data->expected_vehicles;
+        view.arrival_gap_ns = shared_data->arrival_gap_ns[port];
+        view.now = now_ns();
+        int seq = shared_data->arrival_seq;
+        int hold = departure_should_hold(cfg.departure_rule, cfg.min_fill,
+                                         &view);
+        shared_data->ferry_holding = hold;
+        shared_data->departure_holds += hold && !held;
+        sync_post(&shared_data->lock_mutex);
+        if (!hold) {
+            return;
+        }
+        held = 1;
+
+        long long remaining_ns = deadline - view.now;
+        struct timespec timeout = {remaining_ns / NS_PER_SEC,
+                                   remaining_ns % NS_PER_SEC};
+        futex_wait(&shared_data->arrival_seq, seq, &timeout);
+        int boarded = load_ferry(shared_data, cfg);
+        wait_for_boarding(shared_data, boarded);
+        shared_data->held_vehicles += boarded;
+    }
+}
+
+/**
+ * @brief Parks the ferry while no vehicle waits at either linked port
+ * @param shared_data Pointer to shared data
+ * @return 1 if the ferry parked, 0 otherwise
+ *
+ * Asks the server of its own port first, which usually has vehicles, and
+ * waits on both servers for the first arrival.
+ */
+static int park_at_linked_ports(SharedData *shared_data) {
+    int port = shared_data->ferry_port;
+    int other = (port + 1) % 2;
+    int parked = 0;
+    while (1) {
+        PortReply status[2];
+        if (port_link_status(shared_data, port, &status[port]) !=
+            EXIT_SUCCESS) {
+            abort_run(shared_data);
+            return parked;
+        }
+        int idle = status[port].waiting == 0;
+        if (idle && port_link_status(shared_data, other, &status[other]) !=
+                        EXIT_SUCCESS) {
+            abort_run(shared_data);
+            return parked;
+        }
+        idle = idle && status[other].waiting == 0 &&
+               status[0].arrivals + status[1].arrivals <
+                   shared_data->expected_vehicles;
+        shared_data->ferry_idle = idle;
+        shared_data->idle_parks += idle && !parked;
+        if (!idle) {
+            return parked;
+        }
+        parked = 1;
+        int ports[2] = {1, 1};
+        if (port_link_wait(shared_data, ports, -1) != EXIT_SUCCESS) {
+            abort_run(shared_data);
+            return parked;
+        }
+    }
+}
+
+/**
+ * @brief Parks the ferry while no vehicle waits at either port
+ * @param shared_data Pointer to shared data
+ * @param cfg Configuration struct
+ * @return 1 if the ferry parked, 0 otherwise
+ *
+ * Called with an empty deck. Rather than crossing empty until a vehicle
+ * shows up, the ferry sleeps on the arrival sequence and resumes on the
+ * first arrival, or when a stream ends and the run may be over.
+ */
+int park_idle(SharedData *shared_data, Config cfg) {
+    if (!cfg.idle_park) {
+        return 0;
+    }
+    if (cfg.port_link != PORT_LINK_SHARED) {
+        return park_at_linked_ports(shared_data);
+    }
+    int parked = 0;
+    while (1) {
+        sync_wait(&shared_data->lock_mutex);
+        int idle = port_waiting(shared_data, 0) == 0 &&
+                   port_waiting(shared_data, 1) == 0 &&
+                   (shared_data->expected_vehicles < 0 ||
+                    shared_data->arrived_vehicles <
+                        shared_data->expected_vehicles);
+        int seq = shared_data->arrival_seq;
+        shared_data->ferry_idle = idle;
+        shared_data->idle_parks += idle && !parked;
+        sync_post(&shared_data->lock_mutex);
+        if (!idle) {
+            return parked;
+        }
+        parked = 1;
+        futex_wait(&shared_data->arrival_seq, seq, NULL);
+    }
+}
+
+/**
+ * @brief Helper function to translate ferry to another port
+ * @param shared_data Pointer to shared data
+ * @param log For logging
+ */
+void ferry_to_another_port(SharedData *shared_data, const FerrySink *log) {
+    print_action(shared_data, log, 'P', 0, "leaving",
+                 shared_data->ferry_port);
+    sync_wait(&shared_data->lock_mutex);
+    shared_data->ferry_port = (shared_data->ferry_port + 1) % 2;
+    sync_post(&shared_data->lock_mutex);
+}
+
+/**
+ * @brief Helper function to end a ferry phase of a trip
+ * @param trip The trip
+ * @param phase The phase that ended
+ * @param start_ns When the phase started
+ * @param port Port of the ferry
+ * @return When the phase ended, the start of the next one
+ */
+static long long end_phase(TripRecord *trip, TripPhase phase,
+                           long long start_ns, int port) {
+    long long end_ns = now_ns();
+    trip->phase_ns[phase] = end_ns - start_ns;
+    trace_span(trip_phase_name(phase), start_ns, end_ns, port);
+    return end_ns;
+}
+
+/**
+ * @brief Main function for ferry process
+ * @param shared_data Pointer to shared data
+ * @param cfg Config struct
+ *
+ * Main function for ferry process. This function is responsible for
+ * loading and unloading vehicles from the ferry
+ */
+void ferry_process(SharedData *shared_data, Config cfg) {
+    TripLog trips = {0};
+    long long started = now_ns();
+    port_links_attach_ferry();
+    print_action(shared_data, &cfg.log, 'P', 0, "started", -1);
+
+    while (1) {
+        TripRecord trip = {.port = 0};
+        long long messages = shared_data->port_messages[0] +
+                             shared_data->port_messages[1];
+        long long rtt_ns =
+            shared_data->port_rtt[0].sum + shared_data->port_rtt[1].sum;
+        long long phase_start = now_ns();
+        int port = shared_data->ferry_port;
+        // Wait for ferry to arrive
+        model_delay(shared_data, SLEEP_CROSSING, phase_start,
+                    cfg.max_ferry_arrival_us);
+        long long cycle_start =
+            end_phase(&trip, PHASE_CROSSING, phase_start, port);
+        print_action(shared_data, &cfg.log, 'P', 0, "arrived to", port);
+
+        int done = ferry_unload(shared_data);
+        phase_start = end_phase(&trip, PHASE_UNLOADING, cycle_start, port);
+        if (done) {
+            break;
+        }
+        park_idle(shared_data, cfg);
+        phase_start = end_phase(&trip, PHASE_PARKED, phase_start, port);
+
+        // Signal vehicles to load
+        int vehicles_to_load = load_ferry(shared_data, cfg);
+        phase_start = end_phase(&trip, PHASE_LOADING, phase_start, port);
+
+        // Wait for all vehicles to load
+        wait_for_boarding(shared_data, vehicles_to_load);
+        phase_start = end_phase(&trip, PHASE_WAITING, phase_start, port);
+        hold_departure(shared_data, cfg);
+        phase_start = end_phase(&trip, PHASE_HOLDING, phase_start, port);
+        trip.messages = shared_data->port_messages[0] +
+                        shared_data->port_messages[1] - messages;
+        trip.rtt_ns = shared_data->port_rtt[0].sum +
+                      shared_data->port_rtt[1].sum - rtt_ns;
+        record_trip(shared_data, &trips, &trip);
+        // Go to another port
+        ferry_to_another_port(shared_data, &cfg.log);
+        trace_span("leaving", phase_start, now_ns(), port);
+        record_ferry_cycle(shared_data, now_ns() - cycle_start);
+    }
+
+    trip_log_summarize(&trips, cfg.capacity_of_ferry, now_ns() - started,
+                       &shared_data->trip_summary);
+    if (cfg.trip_log_path != NULL) {
+        trip_log_write_csv(&trips, cfg.trip_log_path);
+    }
+    trip_log_free(&trips);
+    port_links_stop();
+    finish_ferry(shared_data, cfg);
+}
+
+/**
+ * @brief Helper function to unload the deck when the ferry arrives
+ * @param shared_data Pointer to shared data
+ * @return 1 if every vehicle of the run has crossed, 0 otherwise
+ *
+ * When the run is not over, the deck counters are reset for loading.
+ */
+int ferry_unload(SharedData *shared_data) {
+    sync_wait(&shared_data->lock_mutex);
+    int curr_vehicles_to_unload = shared_data->vehicles_to_unload;
+    sync_post(&shared_data->lock_mutex);
+    // If there are vehicles to unload unload them
+    if (curr_vehicles_to_unload > 0 &&
+        shared_data->port_link != PORT_LINK_SHARED) {
+        // The vehicles on the deck are held by the port they boarded at
+        int left = port_link_unload(shared_data,
+                                    (shared_data->ferry_port + 1) % 2);
+        if (left == -1) {
+            abort_run(shared_data);
+        }
+        sync_wait(&shared_data->lock_mutex);
+        shared_data->total_vehicles_unloaded += left;
+        sync_post(&shared_data->lock_mutex);
+    } else if (curr_vehicles_to_unload > 0) {
+        unload_vehicles(shared_data);
+        // Wait until all of them reported back
+        sync_wait(&shared_data->unload_complete_sem);
+    }
+
+    sync_wait(&shared_data->lock_mutex);
+    //  Check if there are no more vehicles to work with
+    int done = shared_data->total_vehicles_unloaded ==
+               shared_data->expected_vehicles;
+    if (!done) {
+        // Reset counters
+        shared_data->vehicles_to_unload = 0;
+        for (int cls = 0; cls < shared_data->classes.count; cls++) {
+            shared_data->loaded[cls] = 0;
+        }
+        deck_clear(&shared_data->deck);
+    }
+    sync_post(&shared_data->lock_mutex);
+    return done;
+}
+
+/**
+ * @brief Helper function to account the vehicles of a finished loading
+ * @param shared_data Pointer to shared data
+ * @param trips Trip log of the ferry
+ * @param trip The trip, its phase times already filled in
+ */
+void record_trip(SharedData *shared_data, TripLog *trips, TripRecord *trip) {
+    sync_wait(&shared_data->lock_mutex);
+    trip->port = shared_data->ferry_port;
+    trip->cars = shared_data->loaded[CLASS_CAR];
+    trip->trucks = shared_data->loaded[CLASS_TRUCK];
+    trip->others = deck_vehicles(shared_data) - trip->cars - trip->trucks;
+    trip->units = deck_units(shared_data);
+    sync_post(&shared_data->lock_mutex);
+    if (trip_log_append(trips, trip) != EXIT_SUCCESS) {
+        fprintf(stderr, "[WARNING] Trip log is out of memory\n");
+    }
+}
+
+/**
+ * @brief Helper function to log the end of the ferry and wake the helpers
+ * @param shared_data Pointer to shared data
+ * @param cfg Config struct
+ */
+void finish_ferry(SharedData *shared_data, Config cfg) {
+    print_action(shared_data, &cfg.log, 'P', 0, "leaving",
+                 shared_data->ferry_port);
+    print_action(shared_data, &cfg.log, 'P', 0, "finish", -1);
+    shared_data->end_ns = now_ns();
+    struct timespec cpu;
+    if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu) == 0) {
+        shared_data->ferry_cpu_ns = cpu.tv_sec * NS_PER_SEC + cpu.tv_nsec;
+    }
+    __atomic_store_n(&shared_data->finished, 1, __ATOMIC_RELEASE);
+    futex_wake(&shared_data->finished, INT_MAX);
+}
+
+/**
+ * @brief Helper function to account one ferry cycle at a port
+ * @param shared_data Pointer to shared data
+ * @param cycle_ns Time from arrival to leaving the port
+ *
+ * Only the ferry writes these fields, the parent reads them after it exits.
+ */
+void record_ferry_cycle(SharedData *shared_data, long long cycle_ns) {
+    if (shared_data->ferry_cycles == 0 ||
+        cycle_ns < shared_data->cycle_ns_min) {
+        shared_data->cycle_ns_min = cycle_ns;
+    }
+    if (cycle_ns > shared_data->cycle_ns_max) {
+        shared_data->cycle_ns_max = cycle_ns;
+    }
+    shared_data->cycle_ns_total += cycle_ns;
+    shared_data->ferry_cycles++;
+}
+
+/**
+ * @brief Sleeps a random modelled delay, measured from its start
+ * @param shared_data Pointer to shared data
+ * @param kind What the delay models, one of the SLEEP_ kinds
+ * @param start_ns When the delay started
+ * @param max_us Longest delay
+ *
+ * The deadline is absolute, so time spent since start_ns counts toward the
+ * delay. Every sleep records how late it woke.
+ */
+void model_delay(SharedData *shared_data, int kind, long long start_ns,
+                 int max_us) {
+    int delay_us = rand_range(0, max_us);
+    if (delay_us > 0) {
+        long long late = sleep_until(start_ns + delay_us * NS_PER_US);
+        histogram_record(&shared_data->overshoot[kind], late);
+    }
+}
+
+/**
+ * @brief Helper function to wait for loading signal
+ * @param shared_data Pointer to shared data
+ * @param cls The class of the vehicle
+ * @param port The port of the ferry
+ */
+void wait_for_loading_signal(SharedData *shared_data, int cls, int port) {
+    sync_wait(&shared_data->load_sem[cls][port]);
+}
+
+/**
+ * @brief Helper function to board a vehicle
+ * @param shared_data Pointer to shared data
+ * @param cfg Configuration structure containing the parameters for the
+ * vehicles.
+ * @param cls The class of the vehicle
+ * @param id The id of the vehicle
+ * @param entry Vehicle table entry of the vehicle
+ * @return The deck slot the vehicle parked in
+ */
+int board_vehicle(SharedData *shared_data, Config cfg, int cls, int id,
+                  int entry) {
+    sync_wait(&shared_data->lock_mutex);
+    shared_data->loaded[cls]++;
+    int slot = deck_park(&shared_data->deck, entry);
+    print_action(shared_data, &cfg.log, cfg.classes.classes[cls].letter, id,
+                 "boarding", -1);
+    // Signal to the ferry that I'm done
+    sync_handoff_post(&shared_data->loading_done);
+    sync_post(&shared_data->lock_mutex);
+    return slot;
+}
+
+/**
+ * @brief Stops the run after a vehicle lost the link to its port server
+ * @param shared_data Pointer to shared data
+ * @param port The port
+ */
+static void lose_port_link(SharedData *shared_data, int port) {
+    fprintf(stderr, "[ERROR] A vehicle lost the link to port %d\n", port);
+    abort_run(shared_data);
+    _exit(EXIT_FAILURE);
+}
+
+/**
+ * @brief Waits for a place in the queue of a port
+ * @param shared_data Pointer to shared data
+ * @param cls The class of the vehicle
+ * @param port The port the vehicle is heading to
+ * @param entry Vehicle table entry of the vehicle
+ * @return Connection to the port server with linked ports, -1 otherwise
+ *
+ * Without a queue limit every vehicle is admitted at once. A vehicle that
+ * finds the queue full is held until the ferry boards one from it. With
+ * linked ports the server of the port keeps the queue and admits.
+ */
+int admit_vehicle(SharedData *shared_data, int cls, int port, int entry) {
+    int held = 0;
+    int link = -1;
+    if (shared_data->port_link != PORT_LINK_SHARED) {
+        link = port_link_arrive(port, cls, entry, &held);
+        if (link == -1) {
+            lose_port_link(shared_data, port);
+        }
+    } else {
+        held = shared_data->queue_limit > 0 &&
+               sem_trywait(&shared_data->admit_sem[port]) != 0;
+    }
+    if (!held) {
+        return link;
+    }
+    long long held_ns = now_ns();
+    vehicle_table_set(shared_data->vehicles, entry, VEHICLE_HELD, held_ns);
+    if (link == -1) {
+        sync_wait(&shared_data->admit_sem[port]);
+    } else if (port_link_await(link, PORT_VEHICLE_ADMIT) != EXIT_SUCCESS) {
+        lose_port_link(shared_data, port);
+    }
+    trace_span("held", held_ns, now_ns(), port);
+    held_ns = now_ns() - held_ns;
+
+    sync_wait(&shared_data->lock_mutex);
+    shared_data->refused[port]++;
+    shared_data->refused_ns[port] += held_ns;
+    if (held_ns > shared_data->refused_ns_max) {
+        shared_data->refused_ns_max = held_ns;
+    }
+    sync_post(&shared_data->lock_mutex);
+    return link;
+}
+
+/**
+ * @brief Helper function to add vehicle to port
+ * @param shared_data Pointer to shared data
+ * @param cls The class of the vehicle.
+ * @param port The port to add the vehicle to.
+ * @param arrived_ns Arrival time, used by the boarding policy
+ */
+void add_vehicle_to_port(SharedData *shared_data, int cls, int port,
+                         long long arrived_ns) {
+    sync_wait(&shared_data->lock_mutex);
+    shared_data->waiting[cls][port]++;
+    int waiting = port_waiting(shared_data, port);
+    if (waiting > shared_data->peak_waiting[port]) {
+        shared_data->peak_waiting[port] = waiting;
+    }
+    arrival_queue_push(&shared_data->arrivals[cls][port], arrived_ns);
+    shared_data->arrived_vehicles++;
+    shared_data->arrival_gap_ns[port] =
+        arrival_gap_update(shared_data->arrival_gap_ns[port],
+                           shared_data->last_arrival_ns[port], arrived_ns);
+    if (arrived_ns > shared_data->last_arrival_ns[port]) {
+        shared_data->last_arrival_ns[port] = arrived_ns;
+    }
+    notify_arrival(shared_data);
+    sync_post(&shared_data->lock_mutex);
+}
+
+/**
+ * @brief Wakes a ferry holding its departure or parked idle
+ * @param shared_data Pointer to shared data, lock_mutex held
+ */
+void notify_arrival(SharedData *shared_data) {
+    __atomic_add_fetch(&shared_data->arrival_seq, 1, __ATOMIC_RELEASE);
+    if (shared_data->ferry_holding || shared_data->ferry_idle) {
+        futex_wake(&shared_data->arrival_seq, 1);
+    }
+}
+
+/**
+ * @brief Process a vehicle
+ * @param shared_data Pointer to shared data
+ * @param cfg Configuration structure
+ * @param cls The class of the vehicle, see vehicle_class.h
+ * @param id The ID of the vehicle.
+ * @param port The port the vehicle is heading to.
+ *
+ * Main function for vehicle process that using the shared data and semaphores
+ * to communicate with ferry. With round trips the vehicle stays at the
+ * other port for a random dwell and queues again, until it made every
+ * crossing.
+ */
+void vehicle_process(SharedData *shared_data, Config cfg, int cls, int id,
+                     int port) {
+    const VehicleClass *vehicle_class = &cfg.classes.classes[cls];
+    char vehicle_type = vehicle_class->letter;
+    int entry = vehicle_table_index(shared_data->vehicles, cls, id);
+    long long started_ns = now_ns();
+    vehicle_table_start(shared_data->vehicles, entry, port, started_ns);
+    print_action(shared_data, &cfg.log, vehicle_type, id, "started", -1);
+    // Wait for vehicle to arrive, on the schedule if there is one
+    int slot = shared_data->schedule
+                   ? schedule_slot(shared_data->schedule,
+                                   class_vehicle_index(&cfg.classes, cls, id))
+                   : -1;
+    if (slot >= 0) {
+        schedule_await(shared_data, cfg, slot);
+    } else {
+        model_delay(shared_data, SLEEP_ARRIVAL, started_ns,
+                    vehicle_class->max_arrival_us);
+    }
+    trace_span("driving", started_ns, now_ns(), port);
+
+    for (int crossing = 1;; crossing++) {
+        cross_once(shared_data, cfg, cls, id, entry, port);
+        if (crossing == cfg.crossings) {
+            break;
+        }
+        // Stay at the other port, then queue for the way back
+        port = (port + 1) % 2;
+        long long landed_ns = now_ns();
+        vehicle_table_start(shared_data->vehicles, entry, port, landed_ns);
+        model_delay(shared_data, SLEEP_DWELL, landed_ns, cfg.dwell_us);
+        trace_span("dwell", landed_ns, now_ns(), port);
+    }
+}
+
+/**
+ * @brief Sends a message to the port server and waits for its answer
+ * @param shared_data Pointer to shared data
+ * @param link Connection of the vehicle
+ * @param port The port
+ * @param type The PortVehicleMessageType sent
+ * @param time_ns Time carried by the message
+ * @param answer The PortVehicleMessageType awaited
+ */
+static void ask_port(SharedData *shared_data, int link, int port, int type,
+                     long long time_ns, int answer) {
+    if (port_link_send(link, type, time_ns) != EXIT_SUCCESS ||
+        port_link_await(link, answer) != EXIT_SUCCESS) {
+        lose_port_link(shared_data, port);
+    }
+}
+
+/**
+ * @brief Queues a vehicle at a port and takes it across
+ * @param shared_data Pointer to shared data
+ * @param cfg Configuration structure
+ * @param cls The class of the vehicle
+ * @param id The ID of the vehicle
+ * @param entry Vehicle table entry of the vehicle
+ * @param port The port the vehicle arrives at
+ *
+ * With linked ports the vehicle waits on its connection to the port
+ * server instead of the semaphores, the server calls it on board and
+ * off the deck.
+ */
+void cross_once(SharedData *shared_data, Config cfg, int cls, int id,
+                int entry, int port) {
+    char vehicle_type = cfg.classes.classes[cls].letter;
+    // A vehicle arrives once there is room in the queue
+    int link = admit_vehicle(shared_data, cls, port, entry);
+    long long arrived_ns = now_ns();
+    print_action(shared_data, &cfg.log, vehicle_type, id, "arrived to",
+                 port);
+
+    // Modify waiting amount at port
+    vehicle_table_set(shared_data->vehicles, entry, VEHICLE_WAITING,
+                      arrived_ns);
+    if (link != -1) {
+        ask_port(shared_data, link, port, PORT_VEHICLE_ARRIVED, arrived_ns,
+                 PORT_VEHICLE_BOARD);
+    } else {
+        add_vehicle_to_port(shared_data, cls, port, arrived_ns);
+        // Wait for loading signal
+        wait_for_loading_signal(shared_data, cls, port);
+    }
+    long long wait_ns = now_ns() - arrived_ns;
+    vehicle_table_set(shared_data->vehicles, entry, VEHICLE_ON_DECK,
+                      arrived_ns + wait_ns);
+    trace_span("waiting", arrived_ns, arrived_ns + wait_ns, port);
+
+    int deck_slot = DECK_NONE;
+    if (link != -1) {
+        print_action(shared_data, &cfg.log, vehicle_type, id, "boarding", -1);
+        ask_port(shared_data, link, port, PORT_VEHICLE_BOARDED, 0,
+                 PORT_VEHICLE_LEAVE);
+    } else {
+        // Signal to ferry that I'm boarding
+        sync_handoff_post(&shared_data->vehicle_boarding);
+
+        deck_slot = board_vehicle(shared_data, cfg, cls, id, entry);
+
+        // Wait until the vehicle before me left
+        sync_wait(&shared_data->slot_sem[deck_slot]);
+    }
+
+    // Now I'm leaving
+    print_action(shared_data, &cfg.log, vehicle_type, id, "leaving in",
+                 (port + 1) % 2);
+    long long transit_ns = now_ns() - arrived_ns;
+    vehicle_table_set(shared_data->vehicles, entry, VEHICLE_CROSSED,
+                      arrived_ns + transit_ns);
+    trace_span("on deck", arrived_ns + wait_ns, arrived_ns + transit_ns,
+               (port + 1) % 2);
+    histogram_record(&shared_data->wait_hist[cls][port], wait_ns);
+    histogram_record(&shared_data->transit_hist[cls][port], transit_ns);
+
+    // Notify ferry I’m done
+    sync_wait(&shared_data->lock_mutex);
+    // Edit shared data
+    shared_data->vehicles_unloaded++;
+    shared_data->latency_ns_total += transit_ns;
+    shared_data->latency_count++;
+    if (wait_ns > shared_data->worst_wait_ns) {
+        shared_data->worst_wait_ns = wait_ns;
+        shared_data->worst_type = vehicle_type;
+        shared_data->worst_id = id;
+        shared_data->worst_port = port;
+    }
+    int next = link == -1 ? shared_data->deck.next[deck_slot] : DECK_NONE;
+    sync_post(&shared_data->lock_mutex);
+    // Tell the server, or wake the next vehicle, or tell the ferry the deck
+    // is empty
+    if (link != -1) {
+        if (port_link_send(link, PORT_VEHICLE_LEFT, 0) != EXIT_SUCCESS) {
+            lose_port_link(shared_data, port);
+        }
+        close(link);
+    } else if (next != DECK_NONE) {
+        sync_post(&shared_data->slot_sem[next]);
+    } else {
+        sync_post(&shared_data->unload_complete_sem);
+    }
+}
+
+/**
+ * @brief Creates a new process for the ferry operation.
+ * @param shared_data Pointer to the shared data.
+ * @param cfg Configuration structure.
+ * @return PID of the ferry process.
+ *
+ * With the watchdog, the checker or linked ports the ferry leads a new
+ * process group that the vehicles and port servers join, so a stall, a
+ * violation or a lost link can be killed without touching the parent.
+ */
+pid_t create_ferry_process(SharedData *shared_data, Config cfg) {
+    int own_group =
+        cfg.watchdog_ms > 0 || cfg.check || cfg.port_link != PORT_LINK_SHARED;
+    pid_t ferry_pid = fork();
+    if (ferry_pid == 0) {
+        if (own_group) {
+            setpgid(0, 0);
+        }
+        apply_ferry_placement(cfg);
+        seed_process(cfg, CLASS_NONE, 0);
+        trace_track(TRACE_FERRY, 0, "ferry");
+        ferry_process(shared_data, cfg);
+        trace_flush();
+        // Leave the embedder's stdio buffers and atexit handlers alone
+        _exit(EXIT_SUCCESS);
+    } else if (ferry_pid < 0) {
+        fprintf(stderr, "[ERROR] fork failed\n");
+        exit(EXIT_FAILURE);
+    }
+    if (own_group) {
+        setpgid(ferry_pid, ferry_pid);
+        shared_data->sim_pgid = ferry_pid;
+    }
+    shared_data->ferry_pid = ferry_pid;
+    return ferry_pid;
+}
+
+/**
+ * @brief Applies the ferry CPU and scheduling settings to the caller
+ * @param cfg Configuration structure
+ *
+ * Failures are reported as warnings, the simulation still runs unpinned.
+ */
+void apply_ferry_placement(Config cfg) {
+    if (cfg.ferry_cpu != PLACEMENT_UNSET) {
+        pin_to_cpu(cfg.ferry_cpu);
+    }
+    if (cfg.ferry_fifo > 0) {
+        set_fifo_priority(cfg.ferry_fifo);
+    } else if (cfg.ferry_nice_boost > 0) {
+        boost_priority(cfg.ferry_nice_boost);
+    }
+}
+
+/**
+ * @brief Confines a vehicle or helper process to the vehicle CPU set
+ * @param cfg Configuration structure
+ */
+void apply_helper_placement(Config cfg) {
+    if (cfg.vehicle_cpus_list != NULL) {
+        pin_to_cpu_set(&cfg.vehicle_cpus);
+    }
+}
+
+/**
+ * @brief Returns a stable number identifying a process within a run
+ * @param cls The class of the vehicle, CLASS_NONE for the ferry
+ * @param id The id of the vehicle, 0 for the ferry
+ *
+ * Cars keep their ids and the trucks follow MAX_NUM_CARS, as before
+ * there were classes. Streamed ids past MAX_CLASS_VEHICLES continue after
+ * the last class, interleaved by class.
+ */
+unsigned int process_stream(int cls, int id) {
+    if (cls == CLASS_NONE) {
+        return 0;
+    }
+    if (id > MAX_CLASS_VEHICLES) {
+        return MAX_VEHICLE_CLASSES * MAX_CLASS_VEHICLES +
+               (unsigned int)(id - MAX_CLASS_VEHICLES - 1) *
+                   MAX_VEHICLE_CLASSES +
+               cls + 1;
+    }
+    return cls * MAX_CLASS_VEHICLES + id;
+}
+
+/**
+ * @brief Derives the seed of the random draws of one process
+ * @param seed Run seed, non-zero
+ * @param stream Stable identity of the process, see process_stream()
+ */
+unsigned int stream_seed(int seed, unsigned int stream) {
+    return seed + stream * 7919u;
+}
+
+/**
+ * @brief Seeds the random draws and the schedule fuzzer of a process
+ * @param cfg Configuration structure
+ * @param cls The class of the vehicle, CLASS_NONE for the ferry
+ * @param id The id of the vehicle, 0 for the ferry
+ *
+ * Without --seed every process is seeded by its PID as before.
+ */
+void seed_process(Config cfg, int cls, int id) {
+    unsigned int stream = process_stream(cls, id);
+    rand_state = cfg.seed > 0 ? stream_seed(cfg.seed, stream)
+                              : (unsigned int)getpid();
+    fuzz_init(cfg.fuzz_seed, stream, cfg.fuzz_delay_us);
+}
+
+/**
+ * @brief Creates a specified number of vehicle processes.
+ * @param shared_data Pointer to the shared data.
+ * @param cfg Configuration structure containing the parameters for the
+ * vehicles.
+ * @param cls The class of the vehicles to create.
+ *
+ * Forks a specified number of processes which execute the vehicle
+ * process function. Each process is seeded with the process ID to generate
+ * random port numbers.
+ */
+void create_vehicle_process(SharedData *shared_data, Config cfg, int cls) {
+    const VehicleClass *vehicle_class = &cfg.classes.classes[cls];
+    ArrivalSchedule *schedule = shared_data->schedule;
+    for (int idx = 0; idx < vehicle_class->count; idx++) {
+        // Scheduled vehicles were given their port up front
+        int port = schedule ? schedule->port[schedule_slot(
+                                  schedule, vehicle_class->first + idx)]
+                            : -1;
+        spawn_vehicle(shared_data, cfg, cls, idx + 1, port);
+    }
+}
+
+/**
+ * @brief Forks one vehicle process.
+ * @param shared_data Pointer to the shared data.
+ * @param cfg Configuration structure.
+ * @param cls The class of the vehicle.
+ * @param id The id of the vehicle.
+ * @param port The port the vehicle is heading to, -1 for a random one.
+ * @return PID of the vehicle process.
+ */
+pid_t spawn_vehicle(SharedData *shared_data, Config cfg, int cls, int id,
+                    int port) {
+    pid_t vehicle_pid = fork();
+    if (vehicle_pid > 0 && shared_data->sim_pgid > 0) {
+        setpgid(vehicle_pid, shared_data->sim_pgid);
+    }
+    if (vehicle_pid == 0) {
+        if (shared_data->sim_pgid > 0) {
+            setpgid(0, shared_data->sim_pgid);
+        }
+        // A vehicle that joined after the group was killed leaves at once
+        if (run_over(shared_data)) {
+            _exit(EXIT_SUCCESS);
+        }
+        apply_helper_placement(cfg);
+        // Seed the random number generator
+        seed_process(cfg, cls, id);
+
+        if (port == -1) {
+            port = rand_range(0, 1);
+        }
+
+        char track[TRACE_NAME_LEN];
+        snprintf(track, sizeof(track), "%c %d",
+                 cfg.classes.classes[cls].letter, id);
+        trace_track(TRACE_VEHICLES, process_stream(cls, id), track);
+        vehicle_process(shared_data, cfg, cls, id, port);
+        trace_flush();
+        _exit(EXIT_SUCCESS);
+    } else if (vehicle_pid < 0) {
+        fprintf(stderr, "[ERROR] fork failed\n");
+        exit(EXIT_FAILURE);
+    }
+    return vehicle_pid;
+}
+
+/**
+ * @brief Helper function to destroy a semaphore
+ * @param sem Pointer to the semaphore
+ * @param sem_name Name of the semaphore for error messages
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ */
+int destroy_semaphore(sem_t *sem, const char *sem_name) {
+    if (sem_destroy(sem) == -1) {
+        fprintf(stderr, "[ERROR] sem_destroy failed for %s\n", sem_name);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Function to clean up shared data and semaphores
+ * @param shared_data Pointer to the shared data
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ */
+int cleanup(SharedData *shared_data) {
+    int result = EXIT_SUCCESS;
+
+    // Destroy semaphores
+    SemaphoreSpec sems[SHARED_SEMAPHORES];
+    list_semaphores(shared_data, 0, sems);
+    for (int i = 0; i < SHARED_SEMAPHORES; i++) {
+        if (destroy_semaphore(sems[i].sem, sems[i].name)) {
+            result = EXIT_FAILURE;  // Mark failure but continue cleanup
+        }
+    }
+
+    schedule_destroy(shared_data->schedule);
+    vehicle_table_destroy(shared_data->vehicles);
+    event_ring_destroy(shared_data->events);
+    // Unmap shared memory
+    if (munmap(shared_data, sizeof(SharedData)) == -1) {
+        fprintf(stderr, "[ERROR] munmap failed\n");
+        result = EXIT_FAILURE;
+    }
+    return result;
+}
+
+/**
+ * @brief Helper function to read the value of a semaphore
+ * @param sem Pointer to the semaphore
+ * @return Current value of the semaphore
+ */
+static int sem_value(sem_t *sem) {
+    int value = 0;
+    sem_getvalue(sem, &value);
+    return value;
+}
+
+/**
+ * @brief Dumps every counter and semaphore value of the shared data
+ * @param shared_data Pointer to the shared data
+ *
+ * Reads without taking any lock, so it also works while the simulation is
+ * stuck. Output goes to stderr.
+ */
+void print_shared_data(SharedData *shared_data) {
+    fprintf(stderr, "--- Shared data ---\n");
+    fprintf(stderr, "action_counter: %lld\n", shared_data->action_counter);
+    fprintf(stderr, "ferry_port: %d\n", shared_data->ferry_port);
+    fprintf(stderr, "ferry_capacity: %d\n", shared_data->ferry_capacity);
+    for (int cls = 0; cls < shared_data->classes.count; cls++) {
+        fprintf(stderr, "%s: waiting %d/%d, loaded %d\n",
+                shared_data->classes.classes[cls].name,
+                shared_data->waiting[cls][0], shared_data->waiting[cls][1],
+                shared_data->loaded[cls]);
+    }
+    fprintf(stderr, "vehicles_to_unload: %d, vehicles_unloaded: %d\n",
+            shared_data->vehicles_to_unload, shared_data->vehicles_unloaded);
+    fprintf(stderr, "boarding: %s, next_class: %d, served:",
+            BOARDING_POLICIES[shared_data->boarding.policy].name,
+            shared_data->boarding.next_class);
+    for (int cls = 0; cls < shared_data->classes.count; cls++) {
+        fprintf(stderr, " %lld", shared_data->boarding.served[cls]);
+    }
+    fprintf(stderr, "\n");
+    // Slots still parked with the value of their wake
+    fprintf(stderr, "deck (%s, %d lanes):",
+            unload_order_name(shared_data->deck.order), shared_data->deck.lanes);
+    for (int slot = 0; slot < shared_data->deck.count; slot++) {
+        fprintf(stderr, " %d=%d/%d", slot, shared_data->deck.entry[slot],
+                sem_value(&shared_data->slot_sem[slot]));
+    }
+    fprintf(stderr, "\n");
+    fprintf(stderr, "arrived_vehicles: %lld, ferry_holding: %d, "
+                    "ferry_idle: %d\n",
+            shared_data->arrived_vehicles, shared_data->ferry_holding,
+            shared_data->ferry_idle);
+    fprintf(stderr, "total_vehicles_unloaded: %lld of %lld\n",
+            shared_data->total_vehicles_unloaded,
+            shared_data->expected_vehicles);
+    vehicle_table_print(shared_data->vehicles, VEHICLE_DUMP_IDS, stderr);
+    fprintf(stderr, "--- Semaphores ---\n");
+    fprintf(stderr, "action_counter_sem: %d\n",
+            sem_value(&shared_data->action_counter_sem));
+    fprintf(stderr, "lock_mutex: %d\n", sem_value(&shared_data->lock_mutex));
+    fprintf(stderr, "unload_complete_sem: %d\n",
+            sem_value(&shared_data->unload_complete_sem));
+    for (int cls = 0; cls < shared_data->classes.count; cls++) {
+        fprintf(stderr, "load_sem[%s]: %d/%d\n",
+                shared_data->classes.classes[cls].name,
+                sem_value(&shared_data->load_sem[cls][0]),
+                sem_value(&shared_data->load_sem[cls][1]));
+    }
+    fprintf(stderr, "admit_sem: %d/%d\n", sem_value(&shared_data->admit_sem[0]),
+            sem_value(&shared_data->admit_sem[1]));
+    fprintf(stderr, "vehicle_boarding: %d (%d parked)\n",
+            adaptive_sem_getvalue(&shared_data->vehicle_boarding),
+            shared_data->vehicle_boarding.waiters);
+    fprintf(stderr, "loading_done: %d (%d parked)\n",
+            adaptive_sem_getvalue(&shared_data->loading_done),
+            shared_data->loading_done.waiters);
+}
+
+/**
+ * @brief Prints what idle parking saved the ferry
+ * @param shared_data Pointer to the shared data
+ * @param out Output stream
+ *
+ * Saved crossings are estimated from the parked time and the mean
+ * crossing, as an unparked ferry would have crossed empty meanwhile.
+ */
+static void print_idle_stats(SharedData *shared_data, FILE *out) {
+    const TripSummary *trips = &shared_data->trip_summary;
+    long long parked_ns = trips->phase_ns[PHASE_PARKED];
+    long long crossing_ns =
+        trips->trips > 0 ? trips->phase_ns[PHASE_CROSSING] / trips->trips : 0;
+    fprintf(out, "Idle parking: %lld parks, %.3f ms parked",
+            shared_data->idle_parks, (double)parked_ns / NS_PER_MS);
+    if (shared_data->idle_parks > 0 && crossing_ns > 0) {
+        fprintf(out, ", ~%lld empty crossings saved", parked_ns / crossing_ns);
+    }
+    long long run_ns = shared_data->end_ns - shared_data->start_ns;
+    fprintf(out, "\n  ferry CPU time %.3f ms (%.1f%% of the run)\n",
+            (double)shared_data->ferry_cpu_ns / NS_PER_MS,
+            run_ns > 0 ? 100.0 * shared_data->ferry_cpu_ns / run_ns : 0.0);
+}
+
+/**
+ * @brief Prints how many vehicles full ports held back and for how long
+ * @param shared_data Pointer to the shared data
+ * @param out Output stream
+ */
+static void print_admission_stats(SharedData *shared_data, FILE *out) {
+    if (shared_data->queue_limit == 0) {
+        return;
+    }
+    long long refused = shared_data->refused[0] + shared_data->refused[1];
+    fprintf(out, "  limit %d per port, %lld refused at port 0, %lld at "
+                 "port 1\n",
+            shared_data->queue_limit, shared_data->refused[0],
+            shared_data->refused[1]);
+    if (refused > 0) {
+        fprintf(out, "  held mean %.3f ms, max %.3f ms\n",
+                (double)(shared_data->refused_ns[0] +
+                         shared_data->refused_ns[1]) /
+                    refused / NS_PER_MS,
+                (double)shared_data->refused_ns_max / NS_PER_MS);
+    }
+}
+
+/**
+ * @brief Prints how late the modelled sleeps woke
+ * @param shared_data Pointer to the shared data
+ * @param out Output stream
+ */
+static void print_sleep_stats(SharedData *shared_data, FILE *out) {
+    fprintf(out, "Sleep overshoot (ms):\n  %-28s %8s %9s %9s %9s %9s %9s\n",
+            "", "count", "mean", "p50", "p99", "p99.9", "max");
+    histogram_print(&shared_data->overshoot[SLEEP_CROSSING], "ferry crossing",
+                    out);
+    histogram_print(&shared_data->overshoot[SLEEP_ARRIVAL], "vehicle arrival",
+                    out);
+    if (shared_data->crossings > 1) {
+        histogram_print(&shared_data->overshoot[SLEEP_DWELL], "vehicle dwell",
+                        out);
+    }
+}
+
+/**
+ * @brief Prints the statistics report of a finished run
+ * @param shared_data Pointer to the shared data
+ * @param out Output stream
+ */
+void print_stats(SharedData *shared_data, FILE *out) {
+    fprintf(out, "--- Ferry statistics ---\n");
+    fprintf(out, "Boarding policy: %s\n",
+            BOARDING_POLICIES[shared_data->boarding.policy].name);
+    fprintf(out, "Unload order: %s over %d lanes\n",
+            unload_order_name(shared_data->deck.order), shared_data->deck.lanes);
+    fprintf(out, "Handoffs:\n");
+    adaptive_sem_print_stats(&shared_data->vehicle_boarding,
+                             "vehicle_boarding", out);
+    adaptive_sem_print_stats(&shared_data->loading_done, "loading_done", out);
+
+    long long end_ns = shared_data->finished ? shared_data->end_ns : now_ns();
+    double seconds = (double)(end_ns - shared_data->start_ns) / NS_PER_SEC;
+    fprintf(out, "Vehicles: %lld in %.3f s (%.1f/s), %lld actions\n",
+            shared_data->total_vehicles_unloaded, seconds,
+            shared_data->total_vehicles_unloaded / seconds,
+            shared_data->action_counter - 1);
+    if (shared_data->latency_count > 0) {
+        fprintf(out, "  mean latency from arrival to leaving %.3f ms\n",
+                (double)shared_data->latency_ns_total /
+                    shared_data->latency_count / NS_PER_MS);
+    }
+    if (shared_data->crossings > 1) {
+        fprintf(out, "  %d crossings per vehicle, counted once per crossing\n",
+                shared_data->crossings);
+    }
+
+    fprintf(out, "Queues: peak %d waiting at port 0, %d at port 1\n",
+            shared_data->peak_waiting[0], shared_data->peak_waiting[1]);
+    print_admission_stats(shared_data, out);
+
+    print_latency_stats(shared_data, out);
+    print_sleep_stats(shared_data, out);
+    trip_summary_print(&shared_data->trip_summary, out);
+    if (shared_data->departure_rule != DEPART_IMMEDIATE) {
+        fprintf(out, "Departure rule %s: %lld holds, %lld vehicles boarded "
+                     "while holding\n",
+                departure_rule_name(shared_data->departure_rule),
+                shared_data->departure_holds, shared_data->held_vehicles);
+    }
+
+    print_idle_stats(shared_data, out);
+    print_dispatch_stats(shared_data, out);
+    print_port_link_stats(shared_data, out);
+
+    long long cycles = shared_data->ferry_cycles;
+    fprintf(out, "Ferry cycles at port (arrival to leaving): %lld\n", cycles);
+    if (cycles > 0) {
+        fprintf(out, "  mean %.1f us, min %.1f us, max %.1f us\n",
+                (double)shared_data->cycle_ns_total / cycles / NS_PER_US,
+                (double)shared_data->cycle_ns_min / NS_PER_US,
+                (double)shared_data->cycle_ns_max / NS_PER_US);
+    }
+}
+
+/**
+ * @brief Prints the latency histograms by vehicle class and port
+ * @param shared_data Pointer to the shared data
+ * @param out Output stream
+ */
+void print_latency_stats(SharedData *shared_data, FILE *out) {
+    const char *metrics[2] = {"wait-to-board", "transit"};
+
+    fprintf(out, "Latency (ms):\n  %-28s %8s %9s %9s %9s %9s %9s\n", "",
+            "count", "mean", "p50", "p99", "p99.9", "max");
+    for (int metric = 0; metric < 2; metric++) {
+        Histogram(*hists)[2] =
+            metric == 0 ? shared_data->wait_hist : shared_data->transit_hist;
+        Histogram all;
+        char name[48];
+        histogram_init(&all);
+        for (int cls = 0; cls < shared_data->classes.count; cls++) {
+            for (int port = 0; port < 2; port++) {
+                snprintf(name, sizeof(name), "%s %s port %d", metrics[metric],
+                         shared_data->classes.classes[cls].name, port);
+                histogram_print(&hists[cls][port], name, out);
+                histogram_merge(&all, &hists[cls][port]);
+            }
+        }
+        snprintf(name, sizeof(name), "%s all", metrics[metric]);
+        histogram_print(&all, name, out);
+    }
+    if (shared_data->worst_wait_ns >= 0) {
+        fprintf(out, "  worst-starved: %c %d at port %d waited %.3f ms\n",
+                shared_data->worst_type, shared_data->worst_id,
+                shared_data->worst_port,
+                (double)shared_data->worst_wait_ns / NS_PER_MS);
+    }
+}
+
+/**
+ * @brief Wait for all child processes to finish
+ */
+void wait_for_children(SharedData *shared_data) {
+    pid_t pid;
+    // Wait for all child processes to finish
+    while ((pid = wait(NULL)) > 0) {
+        reap_child(shared_data, pid);
+    }
+}
+
+/**
+ * @brief Accounts a child process the parent reaped
+ * @param shared_data Pointer to the shared data
+ * @param pid The child
+ *
+ * A ferry that exits without finishing leaves nobody to end the run, so
+ * the run is aborted and the helpers stop.
+ */
+void reap_child(SharedData *shared_data, pid_t pid) {
+    if (pid == shared_data->ferry_pid &&
+        !__atomic_load_n(&shared_data->finished, __ATOMIC_ACQUIRE) &&
+        !__atomic_load_n(&shared_data->aborted, __ATOMIC_ACQUIRE)) {
+        fprintf(stderr, "[ERROR] The ferry exited before it finished\n");
+        abort_run(shared_data);
+    }
+}
+
+/**
+ * @brief Stops a run that cannot finish
+ * @param shared_data Pointer to the shared data
+ *
+ * Kills the ferry and vehicle group if there is one, and wakes the helpers
+ * sleeping on the finished word so they see the flag and exit.
+ */
+void abort_run(SharedData *shared_data) {
+    __atomic_store_n(&shared_data->aborted, 1, __ATOMIC_RELEASE);
+    if (shared_data->sim_pgid > 0) {
+        kill(-shared_data->sim_pgid, SIGKILL);
+    }
+    futex_wake(&shared_data->finished, INT_MAX);
+}
+
+/**
+ * @brief Tells the helper loops whether the run ended, either way
+ * @param shared_data Pointer to the shared data
+ * @return 1 once the ferry finished or the run was aborted, 0 otherwise
+ */
+int run_over(SharedData *shared_data) {
+    return __atomic_load_n(&shared_data->finished, __ATOMIC_ACQUIRE) ||
+           __atomic_load_n(&shared_data->aborted, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Runs the simulation on initialized shared data
+ * @param shared_data Pointer to the shared data
+ * @param cfg Configuration structure
+ * @param live Live stats segment to publish to, or NULL
+ * @return EXIT_SUCCESS if the run completed, EXIT_FAILURE otherwise
+ */
+int run_simulation(SharedData *shared_data, Config cfg, LiveStats *live) {
+    // Every process forked from here inherits the slack
+    long slack_ns =
+        cfg.timer_slack_ns > 0 ? timer_slack_set(cfg.timer_slack_ns) : -1;
+    shared_data->start_ns = now_ns();
+    if (cfg.trace_path != NULL &&
+        trace_open(cfg.trace_path, shared_data->start_ns) != EXIT_SUCCESS) {
+        return EXIT_FAILURE;
+    }
+    if (port_links_open(cfg.port_link) != EXIT_SUCCESS) {
+        trace_close();
+        return EXIT_FAILURE;
+    }
+    create_ferry_process(shared_data, cfg);
+    if (cfg.port_link != PORT_LINK_SHARED) {
+        create_port_process(shared_data, cfg, 0);
+        create_port_process(shared_data, cfg, 1);
+    }
+    // Only the ferry and the servers hold the links
+    port_links_close();
+    if (shared_data->schedule != NULL && cfg.dispatch) {
+        create_dispatcher_process(shared_data, cfg);
+    }
+    if (cfg.watchdog_ms > 0) {
+        create_watchdog_process(shared_data, cfg);
+    }
+    if (cfg.check) {
+        create_checker_process(shared_data, cfg);
+    }
+    if (live != NULL) {
+        create_publisher_process(shared_data, cfg, live);
+    }
+    for (int cls = 0; cls < cfg.classes.count; cls++) {
+        create_vehicle_process(shared_data, cfg, cls);
+    }
+    int streamed = cfg.stream_path ? stream_arrivals(shared_data, cfg) : 0;
+    //  Wait for all processes to finish
+    wait_with_reports(shared_data, cfg);
+    // Every traced process appended its spans before it exited
+    trace_close();
+    if (slack_ns != -1) {
+        timer_slack_set(slack_ns);
+    }
+    if (shared_data->stalled || shared_data->check_failed ||
+        shared_data->aborted || streamed != EXIT_SUCCESS) {
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+
+// --- Library interface ---
+
+/**
+ * @brief Creates a simulation
+ * @param cfg Settings of the run, checked with config_validate()
+ * @param log Sink of the action log, still owned by the caller
+ * @return The simulation, or NULL on failure
+ */
+FerrySim *ferry_sim_create(const Config *cfg, FerrySink log) {
+    FerrySim *sim = calloc(1, sizeof(*sim));
+    if (sim == NULL) {
+        fprintf(stderr, "[ERROR] Out of memory\n");
+        return NULL;
+    }
+    sim->cfg = *cfg;
+    sim->cfg.log = log;
+    if (config_validate(&sim->cfg) != EXIT_SUCCESS) {
+        free(sim);
+        return NULL;
+    }
+    if (sim->cfg.live_stats_name != NULL &&
+        (sim->live = live_stats_create(sim->cfg.live_stats_name)) == NULL) {
+        free(sim);
+        return NULL;
+    }
+    sim->shared = init_shared_data(sim->cfg);
+    if (sim->shared == NULL) {
+        ferry_sim_destroy(sim);
+        return NULL;
+    }
+    return sim;
+}
+
+/**
+ * @brief Runs a simulation to the end, a simulation runs only once
+ * @param sim The simulation
+ * @return EXIT_SUCCESS if the run completed, EXIT_FAILURE otherwise
+ */
+int ferry_sim_run(FerrySim *sim) {
+    if (sim->ran) {
+        fprintf(stderr, "[ERROR] The simulation already ran\n");
+        return EXIT_FAILURE;
+    }
+    sim->ran = 1;
+    return run_simulation(sim->shared, sim->cfg, sim->live);
+}
+
+/**
+ * @brief Collects the headline numbers of a finished run
+ * @param sim The simulation
+ * @param stats Where to store the numbers
+ */
+void ferry_sim_stats(const FerrySim *sim, FerryStats *stats) {
+    const SharedData *shared = sim->shared;
+    const TripSummary *trips = &shared->trip_summary;
+    Histogram transit;
+    Histogram wait;
+    histogram_init(&transit);
+    histogram_init(&wait);
+    for (int cls = 0; cls < shared->classes.count; cls++) {
+        for (int port = 0; port < 2; port++) {
+            histogram_merge(&transit, &shared->transit_hist[cls][port]);
+            histogram_merge(&wait, &shared->wait_hist[cls][port]);
+        }
+    }
+
+    long long end_ns = shared->finished ? shared->end_ns : now_ns();
+    stats->vehicles = shared->total_vehicles_unloaded;
+    stats->actions = shared->action_counter - 1;
+    stats->elapsed_ns = end_ns - shared->start_ns;
+    stats->vehicles_per_sec =
+        stats->elapsed_ns > 0
+            ? (double)stats->vehicles * NS_PER_SEC / stats->elapsed_ns
+            : 0.0;
+    stats->transit_p50_ns = histogram_percentile(&transit, 50.0);
+    stats->transit_p99_ns = histogram_percentile(&transit, 99.0);
+    stats->wait_p99_ns = histogram_percentile(&wait, 99.0);
+    stats->trips = trips->trips;
+    stats->empty_trips = trips->empty_trips;
+    stats->fill = trips->units_offered > 0
+                      ? (double)trips->units_used / trips->units_offered
+                      : 0.0;
+    stats->stalled = shared->stalled;
+    stats->idle_parks = shared->idle_parks;
+    stats->ferry_cpu_ns = shared->ferry_cpu_ns;
+    stats->refused = shared->refused[0] + shared->refused[1];
+    Histogram overshoot;
+    histogram_init(&overshoot);
+    for (int kind = 0; kind < SLEEP_KINDS; kind++) {
+        histogram_merge(&overshoot, &shared->overshoot[kind]);
+    }
+    stats->overshoot_p99_ns = histogram_percentile(&overshoot, 99.0);
+}
+
+/**
+ * @brief Prints the statistics report of a run
+ * @param sim The simulation
+ * @param out Output stream
+ */
+void ferry_sim_print_stats(FerrySim *sim, FILE *out) {
+    print_stats(sim->shared, out);
+}
+
+/**
+ * @brief Counts the vehicles of a simulation in a state
+ * @param sim The simulation
+ * @param state The state, see vehicle_table.h
+ * @param port Port to match, or VEHICLE_ANY
+ * @return Number of vehicles, also while the simulation runs
+ */
+int ferry_sim_count_vehicles(const FerrySim *sim, VehicleState state,
+                             int port) {
+    return vehicle_table_count(sim->shared->vehicles, state, port,
+                               VEHICLE_ANY);
+}
+
+/**
+ * @brief Releases a simulation, the log sink is left to the caller
+ * @param sim The simulation
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ */
+int ferry_sim_destroy(FerrySim *sim) {
+    int result = EXIT_SUCCESS;
+    if (sim->live != NULL) {
+        live_stats_destroy(sim->live, sim->cfg.live_stats_name);
+    }
+    if (sim->shared != NULL && cleanup(sim->shared) != EXIT_SUCCESS) {
+        result = EXIT_FAILURE;
+    }
+    free(sim);
+    return result;
+}
@@ -0,0 +1,125 @@
+#include "sink.h"
+
+#include <stdlib.h>    // EXIT_SUCCESS
+#include <string.h>    // memcpy
+#include <sys/mman.h>  // mmap
+
+/**
+ * @brief Returns a sink that discards the log
+ */
+FerrySink sink_none(void) {
+    FerrySink sink = {.kind = SINK_NONE};
+    return sink;
+}
+
+/**
+ * @brief Returns a sink writing to an open stream, which the caller closes
+ * @param file The stream
+ */
+FerrySink sink_file(FILE *file) {
+    FerrySink sink = {.kind = SINK_FILE, .file = file};
+    return sink;
+}
+
+/**
+ * @brief Opens a sink that truncates and writes a file
+ * @param sink Where to store the sink
+ * @param path Path of the file
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ */
+int sink_open_path(FerrySink *sink, const char *path) {
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        fprintf(stderr, "[ERROR] Failed to open file\n");
+        return EXIT_FAILURE;
+    }
+    *sink = sink_file(file);
+    sink->owns_file = 1;
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Opens a sink backed by a shared buffer
+ * @param sink Where to store the sink
+ * @param capacity Bytes the buffer holds, later lines are dropped
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ */
+int sink_open_memory(FerrySink *sink, size_t capacity) {
+    SinkBuffer *buffer =
+        mmap(NULL, sizeof(SinkBuffer) + capacity, PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (buffer == MAP_FAILED) {
+        fprintf(stderr, "[ERROR] mmap failed for the log buffer\n");
+        return EXIT_FAILURE;
+    }
+    buffer->capacity = capacity;
+    sink->kind = SINK_MEMORY;
+    sink->file = NULL;
+    sink->owns_file = 0;
+    sink->buffer = buffer;
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Writes one line, the newline is added here
+ * @param sink The sink
+ * @param line The line without a newline
+ * @param len Length of the line
+ *
+ * Callers serialize writes, the sink does no locking of its own.
+ */
+void sink_write(const FerrySink *sink, const char *line, size_t len) {
+    if (sink->kind == SINK_FILE) {
+        fprintf(sink->file, "%.*s\n", (int)len, line);
+        // Every process has its own stdio buffer, so flush right away
+        fflush(sink->file);
+    } else if (sink->kind == SINK_MEMORY) {
+        SinkBuffer *buffer = sink->buffer;
+        if (buffer->capacity - buffer->length < len + 1) {
+            buffer->dropped += len + 1;
+            return;
+        }
+        memcpy(buffer->data + buffer->length, line, len);
+        buffer->data[buffer->length + len] = '\n';
+        buffer->length += len + 1;
+    }
+}
+
+/**
+ * @brief Returns the log collected by a memory sink
+ * @param sink The sink
+ * @param len Where to store the length of the log
+ * @return The log, or NULL for other sinks
+ */
+const char *sink_text(const FerrySink *sink, size_t *len) {
+    if (sink->kind != SINK_MEMORY) {
+        *len = 0;
+        return NULL;
+    }
+    *len = sink->buffer->length;
+    return sink->buffer->data;
+}
+
+/**
+ * @brief Empties a memory sink so it can take the log of another run
+ * @param sink The sink
+ */
+void sink_reset(FerrySink *sink) {
+    if (sink->kind == SINK_MEMORY) {
+        sink->buffer->length = 0;
+        sink->buffer->dropped = 0;
+    }
+}
+
+/**
+ * @brief Releases the resources of a sink
+ * @param sink The sink
+ */
+void sink_close(FerrySink *sink) {
+    if (sink->kind == SINK_FILE && sink->owns_file) {
+        fclose(sink->file);
+    } else if (sink->kind == SINK_MEMORY) {
+        munmap(sink->buffer, sizeof(SinkBuffer) + sink->buffer->capacity);
+    }
+    *sink = sink_none();
+}
@@ -0,0 +1,48 @@
+#include "timing.h"
+
+#include <errno.h>      // EINTR
+#include <stdio.h>      // fprintf
+#include <sys/prctl.h>  // prctl
+#include <time.h>       // clock_gettime
+
+/**
+ * @brief Reads the monotonic clock
+ * @return Current CLOCK_MONOTONIC time in nanoseconds
+ */
+long long now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * NS_PER_SEC + ts.tv_nsec;
+}
+
+/**
+ * @brief Sleeps until an absolute point of the monotonic clock
+ * @param deadline_ns The deadline
+ * @return How late the caller woke in ns, counting from the deadline even
+ * if it had passed before the call
+ */
+long long sleep_until(long long deadline_ns) {
+    struct timespec deadline = {deadline_ns / NS_PER_SEC,
+                                deadline_ns % NS_PER_SEC};
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) ==
+           EINTR);
+    long long late = now_ns() - deadline_ns;
+    return late > 0 ? late : 0;
+}
+
+/**
+ * @brief Sets the timer slack of the calling process
+ * @param slack_ns The slack, at least 1
+ * @return The previous slack, or -1 on failure
+ *
+ * The kernel may defer a timer by up to the slack to batch wakeups, 50 us
+ * by default. Children forked afterwards inherit the slack.
+ */
+long timer_slack_set(long slack_ns) {
+    long previous = prctl(PR_GET_TIMERSLACK, 0, 0, 0, 0);
+    if (previous == -1 || prctl(PR_SET_TIMERSLACK, slack_ns, 0, 0, 0) == -1) {
+        fprintf(stderr, "[WARNING] Failed to set the timer slack\n");
+        return -1;
+    }
+    return previous;
+}
@@ -0,0 +1,155 @@
+#include "trace.h"
+
+#include <errno.h>   // EINTR
+#include <fcntl.h>   // open
+#include <stdio.h>   // snprintf
+#include <stdlib.h>  // EXIT_SUCCESS
+#include <string.h>  // strlen
+#include <unistd.h>  // write
+
+#include "timing.h"
+
+// --- Process-local state, inherited by every fork ---
+static int trace_fd = -1;        // The trace file, -1 while tracing is off
+static long long trace_origin;   // Monotonic time of timestamp 0
+static int trace_group;          // Trace process of the caller
+static int trace_id;             // Track of the caller in its group
+static size_t trace_used;        // Bytes in trace_buffer
+static char trace_buffer[TRACE_BUFFER_LEN];
+
+/**
+ * @brief Appends bytes to the trace file
+ * @param data The bytes
+ * @param len Number of bytes
+ *
+ * The file is opened with O_APPEND, so the writes of different processes
+ * never overwrite each other.
+ */
+static void trace_write(const char *data, size_t len) {
+    while (len > 0) {
+        ssize_t written = write(trace_fd, data, len);
+        if (written == -1 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return;
+        }
+        data += written;
+        len -= written;
+    }
+}
+
+/**
+ * @brief Adds one formatted event to the buffer of the caller
+ * @param event The event, every event starts with a comma
+ * @param len Length of the event
+ */
+static void trace_append(const char *event, int len) {
+    if (len <= 0 || len >= TRACE_EVENT_LEN) {
+        return;
+    }
+    if (trace_used + len > sizeof(trace_buffer)) {
+        trace_flush();
+    }
+    memcpy(trace_buffer + trace_used, event, len);
+    trace_used += len;
+}
+
+/**
+ * @brief Starts a trace, called by the parent before it forks
+ * @param path Path of the trace file
+ * @param origin_ns Monotonic time of timestamp 0
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ */
+int trace_open(const char *path, long long origin_ns) {
+    trace_fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+    if (trace_fd == -1) {
+        fprintf(stderr, "[ERROR] Failed to open trace %s\n", path);
+        return EXIT_FAILURE;
+    }
+    trace_origin = origin_ns;
+    trace_used = 0;
+    char head[2 * TRACE_EVENT_LEN];
+    int len = snprintf(
+        head, sizeof(head),
+        "[\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":0,"
+        "\"args\":{\"name\":\"ferry\"}},\n"
+        "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":0,"
+        "\"args\":{\"name\":\"vehicles\"}}",
+        TRACE_FERRY, TRACE_VEHICLES);
+    trace_write(head, len);
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Ends the trace, called by the parent after every process exited
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ */
+int trace_close(void) {
+    if (trace_fd == -1) {
+        return EXIT_SUCCESS;
+    }
+    trace_flush();
+    trace_write("\n]\n", 3);
+    int result = close(trace_fd) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    trace_fd = -1;
+    return result;
+}
+
+/**
+ * @brief Names the track the spans of the caller go to
+ * @param group Trace process, TRACE_FERRY or TRACE_VEHICLES
+ * @param track Track within the group
+ * @param name Name shown for the track
+ */
+void trace_track(int group, int track, const char *name) {
+    if (trace_fd == -1) {
+        return;
+    }
+    trace_group = group;
+    trace_id = track;
+    char event[TRACE_EVENT_LEN];
+    int len = snprintf(event, sizeof(event),
+                       ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,"
+                       "\"tid\":%d,\"args\":{\"name\":\"%.*s\"}}",
+                       group, track, TRACE_NAME_LEN, name);
+    trace_append(event, len);
+}
+
+/**
+ * @brief Records a span of the caller
+ * @param name Name of the span
+ * @param begin_ns When it began
+ * @param end_ns When it ended
+ * @param port Port of the span, -1 if none
+ */
+void trace_span(const char *name, long long begin_ns, long long end_ns,
+                int port) {
+    if (trace_fd == -1) {
+        return;
+    }
+    char event[TRACE_EVENT_LEN];
+    int len = snprintf(event, sizeof(event),
+                       ",\n{\"name\":\"%.*s\",\"ph\":\"X\",\"pid\":%d,"
+                       "\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f",
+                       TRACE_NAME_LEN, name, trace_group, trace_id,
+                       (double)(begin_ns - trace_origin) / NS_PER_US,
+                       (double)(end_ns - begin_ns) / NS_PER_US);
+    if (port != -1) {
+        len += snprintf(event + len, sizeof(event) - len,
+                        ",\"args\":{\"port\":%d}", port);
+    }
+    len += snprintf(event + len, sizeof(event) - len, "}");
+    trace_append(event, len);
+}
+
+/**
+ * @brief Writes the buffered spans of the caller, called before it exits
+ */
+void trace_flush(void) {
+    if (trace_fd == -1 || trace_used == 0) {
+        return;
+    }
+    trace_write(trace_buffer, trace_used);
+    trace_used = 0;
+}
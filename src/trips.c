@@ -0,0 +1,149 @@
+#include "trips.h"
+
+#include <stdlib.h>  // realloc
+#include <string.h>  // memset
+
+#include "timing.h"
+
+// --- Constants ---
+#define TRIP_LOG_INITIAL_CAPACITY 256
+
+static const char *PHASE_NAMES[PHASE_COUNT] = {
+    [PHASE_CROSSING] = "crossing",
+    [PHASE_UNLOADING] = "unloading",
+    [PHASE_LOADING] = "loading",
+    [PHASE_WAITING] = "waiting",
+    [PHASE_HOLDING] = "holding",
+    [PHASE_PARKED] = "parked",
+};
+
+/**
+ * @brief Returns the name of a phase, as in the CSV and the trace
+ * @param phase The phase
+ */
+const char *trip_phase_name(TripPhase phase) {
+    return PHASE_NAMES[phase];
+}
+
+/**
+ * @brief Appends a trip to the log, growing it as needed
+ * @param log The trip log
+ * @param record The trip
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ */
+int trip_log_append(TripLog *log, const TripRecord *record) {
+    if (log->count == log->capacity) {
+        size_t capacity =
+            log->capacity ? log->capacity * 2 : TRIP_LOG_INITIAL_CAPACITY;
+        TripRecord *records =
+            realloc(log->records, capacity * sizeof(*records));
+        if (records == NULL) {
+            return EXIT_FAILURE;
+        }
+        log->records = records;
+        log->capacity = capacity;
+    }
+    log->records[log->count++] = *record;
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Frees the records of a trip log
+ * @param log The trip log
+ */
+void trip_log_free(TripLog *log) {
+    free(log->records);
+    memset(log, 0, sizeof(*log));
+}
+
+/**
+ * @brief Aggregates a trip log
+ * @param log The trip log
+ * @param capacity Ferry capacity in units
+ * @param elapsed_ns Ferry run time
+ * @param summary Where to store the aggregates
+ */
+void trip_log_summarize(const TripLog *log, int capacity,
+                        long long elapsed_ns, TripSummary *summary) {
+    memset(summary, 0, sizeof(*summary));
+    summary->elapsed_ns = elapsed_ns;
+    for (size_t i = 0; i < log->count; i++) {
+        const TripRecord *trip = &log->records[i];
+        int vehicles = trip->cars + trip->trucks + trip->others;
+        summary->trips++;
+        summary->empty_trips += vehicles == 0;
+        summary->vehicles += vehicles;
+        summary->units_used += trip->units;
+        summary->units_offered += capacity;
+        for (int phase = 0; phase < PHASE_COUNT; phase++) {
+            summary->phase_ns[phase] += trip->phase_ns[phase];
+        }
+        summary->messages += trip->messages;
+        summary->rtt_ns += trip->rtt_ns;
+    }
+}
+
+/**
+ * @brief Writes every trip as a CSV row
+ * @param log The trip log
+ * @param path Output file
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ */
+int trip_log_write_csv(const TripLog *log, const char *path) {
+    FILE *out = fopen(path, "w");
+    if (out == NULL) {
+        fprintf(stderr, "[ERROR] Failed to open %s\n", path);
+        return EXIT_FAILURE;
+    }
+    fprintf(out, "trip,port,cars,trucks,others,units");
+    for (int phase = 0; phase < PHASE_COUNT; phase++) {
+        fprintf(out, ",%s_ns", PHASE_NAMES[phase]);
+    }
+    fprintf(out, ",messages,rtt_ns\n");
+    for (size_t i = 0; i < log->count; i++) {
+        const TripRecord *trip = &log->records[i];
+        fprintf(out, "%zu,%d,%d,%d,%d,%d", i + 1, trip->port, trip->cars,
+                trip->trucks, trip->others, trip->units);
+        for (int phase = 0; phase < PHASE_COUNT; phase++) {
+            fprintf(out, ",%lld", trip->phase_ns[phase]);
+        }
+        fprintf(out, ",%d,%lld\n", trip->messages, trip->rtt_ns);
+    }
+    return fclose(out) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * @brief Prints the trip aggregates
+ * @param summary The aggregates
+ * @param out Output stream
+ */
+void trip_summary_print(const TripSummary *summary, FILE *out) {
+    long long cycle_ns = 0;
+    for (int phase = 0; phase < PHASE_COUNT; phase++) {
+        cycle_ns += summary->phase_ns[phase];
+    }
+    fprintf(out, "Trips: %lld (%lld empty), %.1f trips/s\n", summary->trips,
+            summary->empty_trips,
+            summary->elapsed_ns > 0
+                ? (double)summary->trips * NS_PER_SEC / summary->elapsed_ns
+                : 0.0);
+    if (summary->trips == 0) {
+        return;
+    }
+    fprintf(out, "  mean fill %.1f%%, %.2f vehicles per trip\n",
+            100.0 * summary->units_used / summary->units_offered,
+            (double)summary->vehicles / summary->trips);
+    fprintf(out, "  cycle share:");
+    for (int phase = 0; phase < PHASE_COUNT; phase++) {
+        fprintf(out, " %s %.1f%%", PHASE_NAMES[phase],
+                cycle_ns > 0 ? 100.0 * summary->phase_ns[phase] / cycle_ns
+                             : 0.0);
+    }
+    fprintf(out, "\n");
+    if (summary->messages > 0) {
+        fprintf(out, "  port links: %.1f messages and %.1f us of "
+                     "round trips per trip\n",
+                (double)summary->messages / summary->trips,
+                (double)summary->rtt_ns / summary->trips / NS_PER_US);
+    }
+}
@@ -0,0 +1,180 @@
+#include "main.h"
+
+// --- Parsing ---
+#define CLASS_SPEC_LEN 256
+#define CLASS_FIELDS 6  // name:letter:size:count[:max_arrival_us[:weight]]
+
+/**
+ * @brief Empties a class table
+ * @param table The table
+ */
+void class_table_init(ClassTable *table) {
+    table->count = 0;
+    table->vehicles = 0;
+    table->min_size = 0;
+}
+
+/**
+ * @brief Fills a table with only the cars and trucks
+ * @param table The table
+ * @param num_cars Number of cars
+ * @param num_trucks Number of trucks
+ *
+ * Both classes arrive at once and have a WFQ weight of 1.
+ */
+void class_table_builtin(ClassTable *table, int num_cars, int num_trucks) {
+    VehicleClass car = {"car", 'O', CAR_SIZE, num_cars, 0, 1, 0};
+    VehicleClass truck = {"truck", 'N', TRUCK_SIZE, num_trucks, 0, 1, 0};
+    class_table_init(table);
+    class_table_add(table, &car);
+    class_table_add(table, &truck);
+}
+
+/**
+ * @brief Appends a class, its vehicles are indexed after the previous ones
+ * @param table The table
+ * @param vehicle_class The class, first is filled in
+ * @return ID of the class, or CLASS_NONE if it cannot be added
+ */
+int class_table_add(ClassTable *table, const VehicleClass *vehicle_class) {
+    if (table->count == MAX_VEHICLE_CLASSES) {
+        fprintf(stderr, "[ERROR] More than %d vehicle classes\n",
+                MAX_VEHICLE_CLASSES);
+        return CLASS_NONE;
+    }
+    if (class_find(table, vehicle_class->letter) != CLASS_NONE ||
+        vehicle_class->letter == 'P') {
+        fprintf(stderr, "[ERROR] Vehicle letter %c is taken\n",
+                vehicle_class->letter);
+        return CLASS_NONE;
+    }
+    int cls = table->count++;
+    table->classes[cls] = *vehicle_class;
+    table->classes[cls].first = table->vehicles;
+    table->vehicles += vehicle_class->count;
+    if (cls == 0 || vehicle_class->size < table->min_size) {
+        table->min_size = vehicle_class->size;
+    }
+    return cls;
+}
+
+/**
+ * @brief Parses one "name:letter:size:count[:max_arrival_us[:weight]]"
+ * @param entry The entry, modified in place
+ * @param max_arrival_us Arrival window when the entry gives none
+ * @param vehicle_class Where to store the class
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ */
+static int parse_class(char *entry, int max_arrival_us,
+                       VehicleClass *vehicle_class) {
+    char *fields[CLASS_FIELDS] = {NULL};
+    int count = 0;
+    char *save;
+    for (char *field = strtok_r(entry, ":", &save);
+         field != NULL && count < CLASS_FIELDS;
+         field = strtok_r(NULL, ":", &save)) {
+        fields[count++] = field;
+    }
+    if (count < 4 || strtok_r(NULL, ":", &save) != NULL) {
+        fprintf(stderr, "[ERROR] Expected name:letter:size:count"
+                        "[:max_arrival_us[:weight]]\n");
+        return EXIT_FAILURE;
+    }
+    if (strlen(fields[0]) >= CLASS_NAME_LEN || strlen(fields[1]) != 1 ||
+        fields[1][0] < 'A' || fields[1][0] > 'Z') {
+        fprintf(stderr, "[ERROR] Invalid vehicle class %s:%s\n", fields[0],
+                fields[1]);
+        return EXIT_FAILURE;
+    }
+    strcpy(vehicle_class->name, fields[0]);
+    vehicle_class->letter = fields[1][0];
+    vehicle_class->max_arrival_us = max_arrival_us;
+    vehicle_class->weight = 1;
+    if (parse_uint(fields[2], 1, MAX_CAPACITY_PARCEL, "class size",
+                   &vehicle_class->size) ||
+        parse_uint(fields[3], 0, MAX_CLASS_VEHICLES, "class count",
+                   &vehicle_class->count) ||
+        (fields[4] && parse_uint(fields[4], MIN_VEHICLE_ARRIVAL_US,
+                                 MAX_VEHICLE_ARRIVAL_US, "class arrival",
+                                 &vehicle_class->max_arrival_us)) ||
+        (fields[5] && parse_uint(fields[5], 1, MAX_WFQ_WEIGHT,
+                                 "class weight", &vehicle_class->weight))) {
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Appends the classes of a comma-separated --classes value
+ * @param table The table
+ * @param spec The classes, e.g. "bus:B:5:20,van:V:2:50:4000"
+ * @param max_arrival_us Arrival window of classes that give none
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ */
+int class_table_parse(ClassTable *table, const char *spec,
+                      int max_arrival_us) {
+    char copy[CLASS_SPEC_LEN];
+    if (strlen(spec) >= sizeof(copy)) {
+        fprintf(stderr, "[ERROR] Vehicle classes too long\n");
+        return EXIT_FAILURE;
+    }
+    strcpy(copy, spec);
+    char *save;
+    for (char *entry = strtok_r(copy, ",", &save); entry != NULL;
+         entry = strtok_r(NULL, ",", &save)) {
+        VehicleClass vehicle_class;
+        if (parse_class(entry, max_arrival_us, &vehicle_class) ||
+            class_table_add(table, &vehicle_class) == CLASS_NONE) {
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Looks up a class by its letter
+ * @param table The table
+ * @param letter Type in the log
+ * @return ID of the class, or CLASS_NONE
+ */
+int class_find(const ClassTable *table, char letter) {
+    for (int cls = 0; cls < table->count; cls++) {
+        if (table->classes[cls].letter == letter) {
+            return cls;
+        }
+    }
+    return CLASS_NONE;
+}
+
+/**
+ * @brief Returns the vehicle index of a batch vehicle
+ * @param table The table
+ * @param cls ID of the class
+ * @param id Id of the vehicle, starting at 1 per class
+ * @return The index, or -1 for a vehicle outside the batch
+ */
+int class_vehicle_index(const ClassTable *table, int cls, int id) {
+    if (cls < 0 || cls >= table->count || id < 1 ||
+        id > table->classes[cls].count) {
+        return -1;
+    }
+    return table->classes[cls].first + id - 1;
+}
+
+/**
+ * @brief Returns the class of a vehicle index
+ * @param table The table
+ * @param vehicle Vehicle index, below table->vehicles
+ * @param id Where to store the id of the vehicle, may be NULL
+ * @return ID of the class
+ */
+int class_of_vehicle(const ClassTable *table, int vehicle, int *id) {
+    int cls = table->count - 1;
+    while (cls > 0 && vehicle < table->classes[cls].first) {
+        cls--;
+    }
+    if (id != NULL) {
+        *id = vehicle - table->classes[cls].first + 1;
+    }
+    return cls;
+}
@@ -0,0 +1,188 @@
+#include "vehicle_table.h"
+
+#include <string.h>    // strcpy
+#include <sys/mman.h>  // mmap
+
+// --- Every array of the mapping starts 8-byte aligned ---
+#define TABLE_ALIGN(size) (((size) + 7) & ~(size_t)7)
+
+static const char *STATE_NAMES[VEHICLE_STATE_COUNT] = {
+    [VEHICLE_UNUSED] = "unused",
+    [VEHICLE_STARTED] = "started",
+    [VEHICLE_HELD] = "held",
+    [VEHICLE_WAITING] = "waiting",
+    [VEHICLE_ON_DECK] = "on deck",
+    [VEHICLE_CROSSED] = "crossed",
+};
+
+/**
+ * @brief Carves an array out of the table mapping
+ * @param next Next free byte, advanced past the array
+ * @param size Size of the array
+ * @return Start of the array
+ */
+static void *carve(char **next, size_t size) {
+    void *array = *next;
+    *next += TABLE_ALIGN(size);
+    return array;
+}
+
+/**
+ * @brief Maps a zeroed table in shared memory
+ * @param classes Vehicle classes of the run
+ * @param streaming Whether vehicles beyond the batch may join, each class
+ * then gets MAX_CLASS_VEHICLES entries and later ids go untracked
+ * @return The table, or NULL on failure
+ */
+VehicleTable *vehicle_table_create(const ClassTable *classes, int streaming) {
+    size_t count = 0;
+    for (int cls = 0; cls < classes->count; cls++) {
+        count += streaming ? MAX_CLASS_VEHICLES : classes->classes[cls].count;
+    }
+    size_t len = TABLE_ALIGN(sizeof(VehicleTable)) +
+                 3 * TABLE_ALIGN(count) +
+                 VEHICLE_STATE_COUNT * TABLE_ALIGN(count * sizeof(long long));
+    VehicleTable *table = mmap(NULL, len, PROT_READ | PROT_WRITE,
+                               MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (table == MAP_FAILED) {
+        fprintf(stderr, "[ERROR] mmap failed for the vehicle table\n");
+        return NULL;
+    }
+    char *next = (char *)table;
+    carve(&next, sizeof(VehicleTable));
+    table->classes = classes->count;
+    table->count = count;
+    table->class_id = carve(&next, count);
+    table->port = carve(&next, count);
+    table->state = carve(&next, count);
+    for (int state = 0; state < VEHICLE_STATE_COUNT; state++) {
+        table->state_ns[state] = carve(&next, count * sizeof(long long));
+    }
+    int index = 0;
+    for (int cls = 0; cls < classes->count; cls++) {
+        const VehicleClass *vehicle_class = &classes->classes[cls];
+        table->first[cls] = index;
+        table->letter[cls] = vehicle_class->letter;
+        strcpy(table->name[cls], vehicle_class->name);
+        int slots = streaming ? MAX_CLASS_VEHICLES : vehicle_class->count;
+        for (int slot = 0; slot < slots; slot++) {
+            table->class_id[index++] = cls;
+        }
+    }
+    table->first[classes->count] = index;
+    table->map_len = len;
+    return table;
+}
+
+/**
+ * @brief Returns the entry of a vehicle
+ * @param table The table, may be NULL
+ * @param cls Class of the vehicle
+ * @param id Id of the vehicle, starting at 1 per class
+ * @return Index of the entry, -1 if the vehicle is not tracked
+ */
+int vehicle_table_index(const VehicleTable *table, int cls, int id) {
+    if (table == NULL || id < 1 || cls < 0 || cls >= table->classes) {
+        return -1;
+    }
+    int index = table->first[cls] + id - 1;
+    return index < table->first[cls + 1] ? index : -1;
+}
+
+/**
+ * @brief Records the start of a vehicle heading to a port
+ * @param table The table, may be NULL
+ * @param index Entry of the vehicle, -1 to do nothing
+ * @param port The port
+ * @param when_ns Start time
+ */
+void vehicle_table_start(VehicleTable *table, int index, int port,
+                         long long when_ns) {
+    if (table == NULL || index < 0) {
+        return;
+    }
+    table->port[index] = port;
+    vehicle_table_set(table, index, VEHICLE_STARTED, when_ns);
+}
+
+/**
+ * @brief Moves a vehicle to a state
+ * @param table The table, may be NULL
+ * @param index Entry of the vehicle, -1 to do nothing
+ * @param state The new state
+ * @param when_ns When the vehicle entered it
+ *
+ * Only the vehicle itself writes its entry. The state is stored last, so
+ * a reader that sees it also sees its timestamp.
+ */
+void vehicle_table_set(VehicleTable *table, int index, VehicleState state,
+                       long long when_ns) {
+    if (table == NULL || index < 0) {
+        return;
+    }
+    table->state_ns[state][index] = when_ns;
+    __atomic_store_n(&table->state[index], state, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Counts the vehicles in a state
+ * @param table The table
+ * @param state The state
+ * @param port Port to match, or VEHICLE_ANY
+ * @param cls Class to match, or VEHICLE_ANY
+ * @return Number of matching vehicles
+ */
+int vehicle_table_count(const VehicleTable *table, VehicleState state,
+                        int port, int cls) {
+    int count = 0;
+    for (int index = 0; index < table->count; index++) {
+        count += table->state[index] == state &&
+                 (port == VEHICLE_ANY || table->port[index] == port) &&
+                 (cls == VEHICLE_ANY || table->class_id[index] == cls);
+    }
+    return count;
+}
+
+/**
+ * @brief Prints the vehicles per state and who waits at each port
+ * @param table The table
+ * @param max_ids Most waiting vehicles listed per port
+ * @param out Output stream
+ */
+void vehicle_table_print(const VehicleTable *table, int max_ids, FILE *out) {
+    fprintf(out, "--- Vehicles ---\n");
+    for (int state = VEHICLE_STARTED; state < VEHICLE_STATE_COUNT; state++) {
+        fprintf(out, "%s:", STATE_NAMES[state]);
+        for (int cls = 0; cls < table->classes; cls++) {
+            fprintf(out, "%s %s %d", cls > 0 ? "," : "", table->name[cls],
+                    vehicle_table_count(table, state, VEHICLE_ANY, cls));
+        }
+        fprintf(out, "\n");
+    }
+    for (int port = 0; port < 2; port++) {
+        fprintf(out, "waiting at port %d:", port);
+        int listed = 0;
+        for (int index = 0; index < table->count && listed < max_ids;
+             index++) {
+            if (table->state[index] != VEHICLE_WAITING ||
+                table->port[index] != port) {
+                continue;
+            }
+            int cls = table->class_id[index];
+            fprintf(out, " %c %d", table->letter[cls],
+                    index - table->first[cls] + 1);
+            listed++;
+        }
+        fprintf(out, "%s\n", listed == max_ids ? " ..." : "");
+    }
+}
+
+/**
+ * @brief Unmaps the table
+ * @param table The table, may be NULL
+ */
+void vehicle_table_destroy(VehicleTable *table) {
+    if (table != NULL) {
+        munmap(table, table->map_len);
+    }
+}
@@ -0,0 +1,89 @@
+#include "watchdog.h"
+
+/**
+ * @brief Prints the last logged events, oldest first
+ * @param shared_data Pointer to the shared data
+ * @param count How many events to print, at most EVENT_HISTORY
+ * @param out Output stream
+ */
+void print_recent_events(SharedData *shared_data, int count, FILE *out) {
+    long long last =
+        __atomic_load_n(&shared_data->action_counter, __ATOMIC_RELAXED);
+    if (count > EVENT_HISTORY) {
+        count = EVENT_HISTORY;
+    }
+    if (count > last - 1) {
+        count = last - 1;
+    }
+    fprintf(out, "Last %d events:\n", count);
+    for (long long number = last - count; number < last; number++) {
+        fprintf(out, "  %s\n",
+                shared_data->recent_events[number % EVENT_HISTORY]);
+    }
+}
+
+/**
+ * @brief Main function for the watchdog process
+ * @param shared_data Pointer to the shared data
+ * @param cfg Configuration structure
+ *
+ * Samples the action counter every quarter of the stall interval. If it
+ * did not move for the whole interval and the ferry is not parked idle,
+ * the state is dumped to stderr and the simulation process group is
+ * killed.
+ */
+void watchdog_process(SharedData *shared_data, Config cfg) {
+    long long interval_ns = cfg.watchdog_ms * NS_PER_MS;
+    long long tick_ns = interval_ns / 4;
+    if (tick_ns < WATCHDOG_MIN_TICK_US * NS_PER_US) {
+        tick_ns = WATCHDOG_MIN_TICK_US * NS_PER_US;
+    }
+    struct timespec tick = {tick_ns / NS_PER_SEC, tick_ns % NS_PER_SEC};
+
+    long long last_counter = -1;
+    long long last_progress = now_ns();
+    while (!run_over(shared_data)) {
+        // Sleeps one tick, the ferry wakes us early when it finishes
+        futex_wait(&shared_data->finished, 0, &tick);
+        long long counter =
+            __atomic_load_n(&shared_data->action_counter, __ATOMIC_RELAXED);
+        long long now = now_ns();
+        // A ferry parked idle waits for arrivals, it is not stalled
+        if (counter != last_counter ||
+            __atomic_load_n(&shared_data->ferry_idle, __ATOMIC_RELAXED)) {
+            last_counter = counter;
+            last_progress = now;
+            continue;
+        }
+        if (now - last_progress < interval_ns) {
+            continue;
+        }
+
+        fprintf(stderr, "[ERROR] Watchdog: no progress for %lld ms\n",
+                (now - last_progress) / NS_PER_MS);
+        print_shared_data(shared_data);
+        print_recent_events(shared_data, cfg.watchdog_events, stderr);
+        shared_data->stalled = 1;
+        abort_run(shared_data);
+        return;
+    }
+}
+
+/**
+ * @brief Creates the watchdog process
+ * @param shared_data Pointer to the shared data
+ * @param cfg Configuration structure
+ * @return PID of the watchdog process
+ */
+pid_t create_watchdog_process(SharedData *shared_data, Config cfg) {
+    pid_t watchdog_pid = fork();
+    if (watchdog_pid == 0) {
+        apply_helper_placement(cfg);
+        watchdog_process(shared_data, cfg);
+        _exit(EXIT_SUCCESS);
+    } else if (watchdog_pid < 0) {
+        fprintf(stderr, "[ERROR] fork failed\n");
+        exit(EXIT_FAILURE);
+    }
+    return watchdog_pid;
+}
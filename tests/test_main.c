@@ -0,0 +1,15 @@
+// test_main.c
+#include <stdlib.h>
+#include <string.h>
+#include "tests.h"
+
+#define PERF_BASELINE "tests/perf_baseline.txt"
+
+// Usage: tests [--perf [BASELINE]]
+int main(int argc, char *argv[]) {
+    if (argc > 1 && strcmp(argv[1], "--perf") == 0) {
+        const char *baseline = argc > 2 ? argv[2] : PERF_BASELINE;
+        return run_perf_tests(baseline) > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+    return run_all_tests() > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -1,254 +1,1161 @@
-// tests.c
-#include <assert.h>
-#include <stdio.h> // For printf
-#include <stdlib.h>
-#include <stdbool.h>
-#include "main.h"
-#include "logger.h"
-
-
-
-// Global flag to track test failures
-static int test_failure = false;
-static int tests_passed = 0;
-static int tests_failed = 0;
-
-// Custom assertion macro with red-colored output (without file name)
-#define ASSERT(actual, expected, message) \
-    do { \
-        if ((actual) != (expected)) { \
-            fprintf(stderr, "\033[31mAssertion failed: %s\n" \
-                            "  Expected: %d\n" \
-                            "  Actual:   %d\n" \
-                            "  In function '%s', line %d\n\033[0m", \
-                    message, (expected), (actual), __func__, __LINE__); \
-            log_test_result(__func__, message, (expected), (actual), 0); \
-            tests_failed++; /* Increment failed test counter */ \
-            return; /* Exit the current test function */ \
-        } else { \
-            log_test_result(__func__, message, (expected), (actual), 1); \
-            tests_passed++; /* Increment passed test counter */ \
-        } \
-    } while (0)
-
-
-void reset_test_counters() {
-    test_failure = false;
-    tests_passed = 0;
-    tests_failed = 0;
-}
-
-
-void test_invalid_num_args() {
-    const char *argv[] = {"program", "10", "20", "50", "500"};
-    Config cfg;
-    int result = parse_args(5, argv, &cfg);
-    ASSERT(result, EXIT_FAILURE, "result == EXIT_FAILURE");
-    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
-}
-
-void test_invalid_arg_values() {
-    const char *argv[] = {"program", "abc", "20", "50", "500", "1000"};
-    Config cfg;
-    int result = parse_args(6, argv, &cfg);
-    ASSERT(result, EXIT_FAILURE, "result == EXIT_FAILURE");
-}
-
-void test_missing_args() {
-    const char *argv[] = {"program", "10", "20", "50", "500"};
-    Config cfg;
-    int result = parse_args(5, argv, &cfg);
-    ASSERT(result, EXIT_FAILURE, "result == EXIT_FAILURE");
-    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
-}
-
-void test_extra_args() {
-    const char *argv[] = {"program", "10", "20", "50", "500", "1000", "extra"};
-    Config cfg;
-    int result = parse_args(7, argv, &cfg);
-    ASSERT(result, EXIT_FAILURE, "result == EXIT_FAILURE");
-    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
-}
-
-void test_valid_args() {
-    const char *argv[] = {"program", "10", "20", "50", "500", "1000"};
-    Config cfg;
-    int result = parse_args(6, argv, &cfg);
-    ASSERT(result, EXIT_SUCCESS, "result == EXIT_SUCCESS");
-    assert(cfg.num_trucks == 10);
-    assert(cfg.num_cars == 20);
-    assert(cfg.capacity_of_ferry == 50);
-    assert(cfg.max_vehicle_arrival_us == 500);
-    assert(cfg.max_ferry_arrival_us == 1000);
-    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
-}
-
-void test_invalid_arg_count_too_few() {
-    const char *argv[] = {"program", "10", "20", "50", "500"};
-    Config cfg;
-    int result = parse_args(5, argv, &cfg); // Too few arguments
-    ASSERT(result, EXIT_FAILURE, "result == EXIT_FAILURE");
-    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
-}
-
-void test_invalid_arg_count_too_many() {
-    const char *argv[] = {"program", "10", "20", "50", "500", "1000", "extra"};
-    Config cfg;
-    int result = parse_args(7, argv, &cfg); // Too many arguments
-    ASSERT(result, EXIT_FAILURE, "result == EXIT_FAILURE");
-    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
-}
-
-void test_invalid_num_trucks_negative() {
-    const char *argv[] = {"program", "-10", "20", "50", "500", "1000"};
-    Config cfg;
-    int result = parse_args(6, argv, &cfg);
-    ASSERT(result, EXIT_FAILURE, "result == EXIT_FAILURE");
-    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
-}
-
-void test_invalid_num_trucks_exceeds_max() {
-    const char *argv[] = {"program", "10001", "20", "50", "500", "1000"};
-    Config cfg;
-    int result = parse_args(6, argv, &cfg);
-    ASSERT(result,  EXIT_FAILURE, "result == EXIT_FAILURE");
-    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
-}
-
-void test_invalid_num_cars_negative() {
-    const char *argv[] = {"program", "10", "-20", "50", "500", "1000"};
-    Config cfg;
-    int result = parse_args(6, argv, &cfg);
-    ASSERT(result,  EXIT_FAILURE, "result == EXIT_FAILURE");
-    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
-}
-
-void test_invalid_num_cars_exceeds_max() {
-    const char *argv[] = {"program", "10", "10001", "50", "500", "1000"};
-    Config cfg;
-    int result = parse_args(6, argv, &cfg);
-    ASSERT(result,  EXIT_FAILURE, "result == EXIT_FAILURE");
-    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
-}
-
-void test_invalid_capacity_below_min() {
-    const char *argv[] = {"program", "10", "20", "2", "500", "1000"};
-    Config cfg;
-    int result = parse_args(6, argv, &cfg);
-    ASSERT(result,  EXIT_FAILURE, "result == EXIT_FAILURE");
-    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
-}
-
-void test_invalid_capacity_above_max() {
-    const char *argv[] = {"program", "10", "20", "101", "500", "1000"};
-    Config cfg;
-    int result = parse_args(6, argv, &cfg);
-    ASSERT(result,  EXIT_FAILURE, "result == EXIT_FAILURE");
-    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
-}
-
-void test_invalid_max_car_arrival_us_below_min() {
-    const char *argv[] = {"program", "10", "20", "50", "-1", "1000"};
-    Config cfg;
-    int result = parse_args(6, argv, &cfg);
-    ASSERT(result, EXIT_FAILURE, "result == EXIT_FAILURE");
-    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
-}
-
-void test_invalid_max_car_arrival_us_above_max() {
-    const char *argv[] = {"program", "10", "20", "50", "10001", "1000"};
-    Config cfg;
-    int result = parse_args(6, argv, &cfg);
-    ASSERT(result,  EXIT_FAILURE, "result == EXIT_FAILURE");
-    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
-}
-
-void test_invalid_max_truck_arrival_us_below_min() {
-    const char *argv[] = {"program", "10", "20", "50", "500", "-1"};
-    Config cfg;
-    int result = parse_args(6, argv, &cfg);
-    ASSERT(result,  EXIT_FAILURE, "result == EXIT_FAILURE");
-    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
-}
-
-void test_invalid_max_truck_arrival_us_above_max() {
-    const char *argv[] = {"program", "10", "20", "50", "500", "1001"};
-    Config cfg;
-    int result = parse_args(6, argv, &cfg);
-    ASSERT(result,  EXIT_FAILURE, "result == EXIT_FAILURE");
-    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
-}
-
-void test_edge_case_min_values() {
-    const char *argv[] = {"program", "0", "0", "3", "0", "0"};
-    Config cfg;
-    int result = parse_args(6, argv, &cfg);
-    ASSERT(result,  EXIT_SUCCESS, "result == EXIT_SUCCESS");
-    assert(cfg.num_trucks == 0);
-    assert(cfg.num_cars == 0);
-    assert(cfg.capacity_of_ferry == 3);
-    assert(cfg.max_vehicle_arrival_us == 0);
-    assert(cfg.max_ferry_arrival_us == 0);
-    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
-}
-
-void test_edge_case_max_values() {
-    const char *argv[] = {"program", "10000", "10000", "100", "10000", "1000"};
-    Config cfg;
-    int result = parse_args(6, argv, &cfg);
-    ASSERT(result,  EXIT_SUCCESS, "result == EXIT_SUCCESS");
-    assert(cfg.num_trucks == 10000);
-    assert(cfg.num_cars == 10000);
-    assert(cfg.capacity_of_ferry == 100);
-    assert(cfg.max_vehicle_arrival_us == 10000);
-    assert(cfg.max_ferry_arrival_us == 1000);
-    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
-}
-
-void run_args_test() {
-
-    init_log("arg_tests.log"); // Initialize the log file
-
-    printf("\033[34mRunning args tests...\033[0m\n");
-    test_valid_args();
-    test_invalid_arg_count_too_few();
-    test_invalid_arg_count_too_many();
-    test_invalid_num_trucks_negative();
-    test_invalid_num_trucks_exceeds_max();
-    test_invalid_num_cars_negative();
-    test_invalid_num_cars_exceeds_max();
-    test_invalid_capacity_below_min();
-    test_invalid_capacity_above_max();
-    test_invalid_max_car_arrival_us_below_min();
-    test_invalid_max_car_arrival_us_above_max();
-    test_invalid_max_truck_arrival_us_below_min();
-    test_invalid_max_truck_arrival_us_above_max();
-    test_edge_case_min_values();
-    test_edge_case_max_values();
-    test_extra_args();
-    test_missing_args();
-    test_invalid_arg_values();
-    test_invalid_num_args();
-
-    close_log(); // Close the log file
-
-    // Report overall test status
-    printf("\nTest Summary:\n");
-    printf("  Passed: %d\n", tests_passed);
-    printf("  Failed: %d\n", tests_failed);
-
-    if (tests_failed > 0) {
-        printf("\033[31mSome tests failed. Check the log file for details.\033[0m\n");
-    } else {
-        printf("\033[32mAll tests passed!\033[0m\n");
-    }
-    reset_test_counters();
-
-    
-}
-
-
-void run_all_tests() {
-    run_args_test();
-   
+// tests.c
+#include <assert.h>
+#include <signal.h> // For kill
+#include <stdio.h> // For printf
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "checker.h"
+#include "dispatcher.h"
+#include "ferry.h"
+#include "invariants.h"
+#include "logger.h"
+#include "port_server.h"
+#include "publisher.h"
+#include "tests.h"
+
+
+
+// Global flag to track test failures
+static int test_failure = false;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Custom assertion macro with red-colored output (without file name)
+#define ASSERT(actual, expected, message) \
+    do { \
+        if ((actual) != (expected)) { \
+            fprintf(stderr, "\033[31mAssertion failed: %s\n" \
+                            "  Expected: %d\n" \
+                            "  Actual:   %d\n" \
+                            "  In function '%s', line %d\n\033[0m", \
+                    message, (expected), (actual), __func__, __LINE__); \
+            log_test_result(__func__, message, (expected), (actual), 0); \
+            tests_failed++; /* Increment failed test counter */ \
+            return; /* Exit the current test function */ \
+        } else { \
+            log_test_result(__func__, message, (expected), (actual), 1); \
+            tests_passed++; /* Increment passed test counter */ \
+        } \
+    } while (0)
+
+// Like ASSERT, but passes while actual does not exceed limit
+#define ASSERT_AT_MOST(actual, limit, message) \
+    do { \
+        if ((actual) > (limit)) { \
+            fprintf(stderr, "\033[31mAssertion failed: %s\n" \
+                            "  Limit:    %d\n" \
+                            "  Actual:   %d\n" \
+                            "  In function '%s', line %d\n\033[0m", \
+                    message, (limit), (actual), __func__, __LINE__); \
+            log_test_result(__func__, message, (limit), (actual), 0); \
+            tests_failed++; \
+            return; \
+        } else { \
+            log_test_result(__func__, message, (limit), (actual), 1); \
+            tests_passed++; \
+        } \
+    } while (0)
+
+
+void reset_test_counters() {
+    test_failure = false;
+    tests_passed = 0;
+    tests_failed = 0;
+}
+
+// Prints the summary of a test group, resets the counters and returns the
+// number of failed tests
+int report_test_summary() {
+    int failed = tests_failed;
+
+    printf("\nTest Summary:\n");
+    printf("  Passed: %d\n", tests_passed);
+    printf("  Failed: %d\n", tests_failed);
+
+    if (tests_failed > 0) {
+        printf("\033[31mSome tests failed. Check the log file for details.\033[0m\n");
+    } else {
+        printf("\033[32mAll tests passed!\033[0m\n");
+    }
+    reset_test_counters();
+    return failed;
+}
+
+
+// Parses and resolves the arguments, as main() and ferry_sim_create() do
+int parse_config(int argc, const char *argv[], Config *cfg) {
+    if (parse_args(argc, argv, cfg) != EXIT_SUCCESS) {
+        return EXIT_FAILURE;
+    }
+    return config_validate(cfg);
+}
+
+void test_invalid_num_args() {
+    const char *argv[] = {"program", "10", "20", "50", "500"};
+    Config cfg;
+    int result = parse_args(5, argv, &cfg);
+    ASSERT(result, EXIT_FAILURE, "result == EXIT_FAILURE");
+    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
+}
+
+void test_invalid_arg_values() {
+    const char *argv[] = {"program", "abc", "20", "50", "500", "1000"};
+    Config cfg;
+    int result = parse_args(6, argv, &cfg);
+    ASSERT(result, EXIT_FAILURE, "result == EXIT_FAILURE");
+}
+
+void test_missing_args() {
+    const char *argv[] = {"program", "10", "20", "50", "500"};
+    Config cfg;
+    int result = parse_args(5, argv, &cfg);
+    ASSERT(result, EXIT_FAILURE, "result == EXIT_FAILURE");
+    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
+}
+
+void test_extra_args() {
+    const char *argv[] = {"program", "10", "20", "50", "500", "1000", "extra"};
+    Config cfg;
+    int result = parse_args(7, argv, &cfg);
+    ASSERT(result, EXIT_FAILURE, "result == EXIT_FAILURE");
+    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
+}
+
+void test_valid_args() {
+    const char *argv[] = {"program", "10", "20", "50", "500", "1000"};
+    Config cfg;
+    int result = parse_args(6, argv, &cfg);
+    ASSERT(result, EXIT_SUCCESS, "result == EXIT_SUCCESS");
+    assert(cfg.num_trucks == 10);
+    assert(cfg.num_cars == 20);
+    assert(cfg.capacity_of_ferry == 50);
+    assert(cfg.max_vehicle_arrival_us == 500);
+    assert(cfg.max_ferry_arrival_us == 1000);
+    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
+}
+
+void test_invalid_arg_count_too_few() {
+    const char *argv[] = {"program", "10", "20", "50", "500"};
+    Config cfg;
+    int result = parse_args(5, argv, &cfg); // Too few arguments
+    ASSERT(result, EXIT_FAILURE, "result == EXIT_FAILURE");
+    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
+}
+
+void test_invalid_arg_count_too_many() {
+    const char *argv[] = {"program", "10", "20", "50", "500", "1000", "extra"};
+    Config cfg;
+    int result = parse_args(7, argv, &cfg); // Too many arguments
+    ASSERT(result, EXIT_FAILURE, "result == EXIT_FAILURE");
+    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
+}
+
+void test_invalid_num_trucks_negative() {
+    const char *argv[] = {"program", "-10", "20", "50", "500", "1000"};
+    Config cfg;
+    int result = parse_args(6, argv, &cfg);
+    ASSERT(result, EXIT_FAILURE, "result == EXIT_FAILURE");
+    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
+}
+
+void test_invalid_num_trucks_exceeds_max() {
+    const char *argv[] = {"program", "10001", "20", "50", "500", "1000"};
+    Config cfg;
+    int result = parse_args(6, argv, &cfg);
+    ASSERT(result,  EXIT_FAILURE, "result == EXIT_FAILURE");
+    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
+}
+
+void test_invalid_num_cars_negative() {
+    const char *argv[] = {"program", "10", "-20", "50", "500", "1000"};
+    Config cfg;
+    int result = parse_args(6, argv, &cfg);
+    ASSERT(result,  EXIT_FAILURE, "result == EXIT_FAILURE");
+    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
+}
+
+void test_invalid_num_cars_exceeds_max() {
+    const char *argv[] = {"program", "10", "10001", "50", "500", "1000"};
+    Config cfg;
+    int result = parse_args(6, argv, &cfg);
+    ASSERT(result,  EXIT_FAILURE, "result == EXIT_FAILURE");
+    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
+}
+
+void test_invalid_capacity_below_min() {
+    const char *argv[] = {"program", "10", "20", "2", "500", "1000"};
+    Config cfg;
+    int result = parse_args(6, argv, &cfg);
+    ASSERT(result,  EXIT_FAILURE, "result == EXIT_FAILURE");
+    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
+}
+
+void test_invalid_capacity_above_max() {
+    const char *argv[] = {"program", "10", "20", "101", "500", "1000"};
+    Config cfg;
+    int result = parse_args(6, argv, &cfg);
+    ASSERT(result,  EXIT_FAILURE, "result == EXIT_FAILURE");
+    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
+}
+
+void test_invalid_max_car_arrival_us_below_min() {
+    const char *argv[] = {"program", "10", "20", "50", "-1", "1000"};
+    Config cfg;
+    int result = parse_args(6, argv, &cfg);
+    ASSERT(result, EXIT_FAILURE, "result == EXIT_FAILURE");
+    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
+}
+
+void test_invalid_max_car_arrival_us_above_max() {
+    const char *argv[] = {"program", "10", "20", "50", "10001", "1000"};
+    Config cfg;
+    int result = parse_args(6, argv, &cfg);
+    ASSERT(result,  EXIT_FAILURE, "result == EXIT_FAILURE");
+    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
+}
+
+void test_invalid_max_truck_arrival_us_below_min() {
+    const char *argv[] = {"program", "10", "20", "50", "500", "-1"};
+    Config cfg;
+    int result = parse_args(6, argv, &cfg);
+    ASSERT(result,  EXIT_FAILURE, "result == EXIT_FAILURE");
+    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
+}
+
+void test_invalid_max_truck_arrival_us_above_max() {
+    const char *argv[] = {"program", "10", "20", "50", "500", "1001"};
+    Config cfg;
+    int result = parse_args(6, argv, &cfg);
+    ASSERT(result,  EXIT_FAILURE, "result == EXIT_FAILURE");
+    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
+}
+
+void test_edge_case_min_values() {
+    const char *argv[] = {"program", "0", "0", "3", "0", "0"};
+    Config cfg;
+    int result = parse_args(6, argv, &cfg);
+    ASSERT(result,  EXIT_SUCCESS, "result == EXIT_SUCCESS");
+    assert(cfg.num_trucks == 0);
+    assert(cfg.num_cars == 0);
+    assert(cfg.capacity_of_ferry == 3);
+    assert(cfg.max_vehicle_arrival_us == 0);
+    assert(cfg.max_ferry_arrival_us == 0);
+    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
+}
+
+void test_edge_case_max_values() {
+    const char *argv[] = {"program", "10000", "10000", "100", "10000", "1000"};
+    Config cfg;
+    int result = parse_args(6, argv, &cfg);
+    ASSERT(result,  EXIT_SUCCESS, "result == EXIT_SUCCESS");
+    assert(cfg.num_trucks == 10000);
+    assert(cfg.num_cars == 10000);
+    assert(cfg.capacity_of_ferry == 100);
+    assert(cfg.max_vehicle_arrival_us == 10000);
+    assert(cfg.max_ferry_arrival_us == 1000);
+    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
+}
+
+void test_valid_options() {
+    const char *argv[] = {"program", "--stats", "10", "20", "50", "500",
+                          "1000", "--spin-max=0", "--ferry-cpu=2"};
+    Config cfg;
+    int result = parse_args(9, argv, &cfg);
+    ASSERT(result, EXIT_SUCCESS, "result == EXIT_SUCCESS");
+    assert(cfg.num_trucks == 10);
+    assert(cfg.max_ferry_arrival_us == 1000);
+    assert(cfg.stats == 1);
+    assert(cfg.spin_max == 0);
+    assert(cfg.vehicle_cpus_list == NULL);
+    assert(cfg.ferry_cpu == 2);
+    assert(strcmp(cfg.policy_name, DEFAULT_BOARDING_POLICY) == 0);
+    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
+}
+
+void test_invalid_options() {
+    const char *argv[] = {"program", "10", "20", "50", "500", "1000",
+                          "--no-such-option"};
+    Config cfg;
+    int result = parse_config(7, argv, &cfg);
+    ASSERT(result, EXIT_FAILURE, "result == EXIT_FAILURE");
+    const char *argv_range[] = {"program", "10", "20", "50", "500", "1000",
+                                "--spin-max=100000"};
+    result = parse_config(7, argv_range, &cfg);
+    ASSERT(result, EXIT_FAILURE, "result == EXIT_FAILURE");
+    const char *argv_cpus[] = {"program", "10", "20", "50", "500", "1000",
+                               "--vehicle-cpus=3-1"};
+    result = parse_config(7, argv_cpus, &cfg);
+    ASSERT(result, EXIT_FAILURE, "result == EXIT_FAILURE");
+    const char *argv_policy[] = {"program", "10", "20", "50", "500", "1000",
+                                 "--policy=random"};
+    result = parse_config(7, argv_policy, &cfg);
+    ASSERT(result, EXIT_FAILURE, "result == EXIT_FAILURE");
+    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
+}
+
+void test_boarding_policy_option() {
+    const char *argv[] = {"program", "10", "20", "50", "500", "1000",
+                          "--policy=wfq", "--wfq-truck-weight=3"};
+    Config cfg;
+    int result = parse_config(8, argv, &cfg);
+    ASSERT(result, EXIT_SUCCESS, "result == EXIT_SUCCESS");
+    assert(strcmp(BOARDING_POLICIES[cfg.boarding_policy].name, "wfq") == 0);
+    assert(cfg.wfq_car_weight == 1);
+    assert(cfg.wfq_truck_weight == 3);
+    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
+}
+
+void test_departure_options() {
+    const char *argv[] = {"program", "10", "20", "50", "500", "1000",
+                          "--depart=ewma", "--hold-us=2000", "--min-fill=80"};
+    Config cfg;
+    int result = parse_config(9, argv, &cfg);
+    ASSERT(result, EXIT_SUCCESS, "result == EXIT_SUCCESS");
+    assert(cfg.departure_rule == DEPART_EWMA);
+    assert(cfg.hold_us == 2000);
+    assert(cfg.min_fill == 80);
+    const char *argv_rule[] = {"program", "10", "20", "50", "500", "1000",
+                               "--depart=never"};
+    result = parse_config(7, argv_rule, &cfg);
+    ASSERT(result, EXIT_FAILURE, "result == EXIT_FAILURE");
+    const char *argv_watchdog[] = {"program", "10", "20", "50", "500", "1000",
+                                   "--depart=hold", "--hold-us=5000",
+                                   "--watchdog-ms=5"};
+    result = parse_config(9, argv_watchdog, &cfg);
+    ASSERT(result, EXIT_FAILURE, "result == EXIT_FAILURE");
+    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
+}
+
+int run_args_test() {
+
+    init_log("arg_tests.log"); // Initialize the log file
+
+    printf("\033[34mRunning args tests...\033[0m\n");
+    test_valid_args();
+    test_invalid_arg_count_too_few();
+    test_invalid_arg_count_too_many();
+    test_invalid_num_trucks_negative();
+    test_invalid_num_trucks_exceeds_max();
+    test_invalid_num_cars_negative();
+    test_invalid_num_cars_exceeds_max();
+    test_invalid_capacity_below_min();
+    test_invalid_capacity_above_max();
+    test_invalid_max_car_arrival_us_below_min();
+    test_invalid_max_car_arrival_us_above_max();
+    test_invalid_max_truck_arrival_us_below_min();
+    test_invalid_max_truck_arrival_us_above_max();
+    test_edge_case_min_values();
+    test_edge_case_max_values();
+    test_extra_args();
+    test_missing_args();
+    test_invalid_arg_values();
+    test_invalid_num_args();
+    test_valid_options();
+    test_invalid_options();
+    test_boarding_policy_option();
+    test_departure_options();
+
+    close_log(); // Close the log file
+
+    // Report overall test status
+    return report_test_summary();
+}
+
+// --- Simulation tests, run in-process through libferry ---
+#define SIM_TEST_RUNS 50
+#define SIM_TEST_LOG_LEN (1 << 20)
+
+// Fills a small seeded run, every seed gets other counts and a policy
+void sim_test_config(Config *cfg, int seed) {
+    config_defaults(cfg);
+    cfg->num_trucks = seed % 7;
+    cfg->num_cars = seed % 11;
+    cfg->capacity_of_ferry = MIN_CAPACITY_PARCEL + seed % 8;
+    cfg->max_vehicle_arrival_us = 100;
+    cfg->max_ferry_arrival_us = 50;
+    cfg->seed = seed;
+    cfg->fuzz_seed = seed;
+    cfg->policy_name = BOARDING_POLICIES[seed % BOARDING_POLICY_COUNT].name;
+}
+
+void test_simulation_logs_are_valid() {
+    FerrySink log;
+    int result = sink_open_memory(&log, SIM_TEST_LOG_LEN);
+    ASSERT(result, EXIT_SUCCESS, "sink_open_memory() == EXIT_SUCCESS");
+    for (int seed = 1; seed <= SIM_TEST_RUNS; seed++) {
+        Config cfg;
+        sim_test_config(&cfg, seed);
+        sink_reset(&log);
+        FerrySim *sim = ferry_sim_create(&cfg, log);
+        ASSERT(sim != NULL, 1, "ferry_sim_create() != NULL");
+        result = ferry_sim_run(sim);
+        ASSERT(result, EXIT_SUCCESS, "result == EXIT_SUCCESS");
+
+        size_t len;
+        const char *text = sink_text(&log, &len);
+        FILE *in = fmemopen((void *)text, len, "r");
+        char error[INVARIANT_ERROR_LEN];
+        config_validate(&cfg);
+        int valid = invariant_check_file(in, &cfg.classes,
+                                         cfg.capacity_of_ferry, cfg.crossings,
+                                         error, sizeof(error));
+        fclose(in);
+        if (valid != EXIT_SUCCESS) {
+            fprintf(stderr, "seed %d: %s\n", seed, error);
+        }
+        ASSERT(valid, EXIT_SUCCESS, "log is valid");
+        result = ferry_sim_destroy(sim);
+        ASSERT(result, EXIT_SUCCESS, "destroy == EXIT_SUCCESS");
+    }
+    sink_close(&log);
+    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
+}
+
+void test_simulation_stats() {
+    Config cfg;
+    sim_test_config(&cfg, 12);
+    FerrySim *sim = ferry_sim_create(&cfg, sink_none());
+    ASSERT(sim != NULL, 1, "ferry_sim_create() != NULL");
+    int result = ferry_sim_run(sim);
+    ASSERT(result, EXIT_SUCCESS, "result == EXIT_SUCCESS");
+    result = ferry_sim_run(sim);
+    ASSERT(result, EXIT_FAILURE, "second run == EXIT_FAILURE");
+    FerryStats stats;
+    ferry_sim_stats(sim, &stats);
+    ASSERT((int)stats.vehicles, cfg.num_trucks + cfg.num_cars,
+           "stats.vehicles == num_trucks + num_cars");
+    ASSERT(stats.stalled, 0, "stats.stalled == 0");
+    assert(stats.trips > 0 && stats.elapsed_ns > 0);
+    ASSERT(ferry_sim_count_vehicles(sim, VEHICLE_CROSSED, VEHICLE_ANY),
+           cfg.num_trucks + cfg.num_cars, "every vehicle crossed");
+    ASSERT(ferry_sim_count_vehicles(sim, VEHICLE_WAITING, 1), 0,
+           "nobody waits at port 1");
+    assert(stats.transit_p50_ns <= stats.transit_p99_ns);
+    result = ferry_sim_destroy(sim);
+    ASSERT(result, EXIT_SUCCESS, "destroy == EXIT_SUCCESS");
+    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
+}
+
+void test_simulation_idle_park() {
+    Config cfg;
+    sim_test_config(&cfg, 1);
+    cfg.num_trucks = 0;
+    cfg.num_cars = 1;
+    cfg.max_vehicle_arrival_us = MAX_VEHICLE_ARRIVAL_US;
+    cfg.max_ferry_arrival_us = 0;
+    FerrySim *sim = ferry_sim_create(&cfg, sink_none());
+    ASSERT(sim != NULL, 1, "ferry_sim_create() != NULL");
+    int result = ferry_sim_run(sim);
+    ASSERT(result, EXIT_SUCCESS, "result == EXIT_SUCCESS");
+    FerryStats stats;
+    ferry_sim_stats(sim, &stats);
+    // Parked until the car arrived, at most one empty crossing to its port
+    ASSERT(stats.empty_trips <= 1, 1, "stats.empty_trips <= 1");
+    result = ferry_sim_destroy(sim);
+    ASSERT(result, EXIT_SUCCESS, "destroy == EXIT_SUCCESS");
+    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
+}
+
+void test_arrival_schedule() {
+    Config cfg;
+    sim_test_config(&cfg, 5);
+    cfg.num_trucks = 40;
+    cfg.num_cars = 60;
+    cfg.max_vehicle_arrival_us = MAX_VEHICLE_ARRIVAL_US;
+    ASSERT(config_validate(&cfg), EXIT_SUCCESS, "config_validate()");
+    // The caller's rand() state is left alone
+    srand(77);
+    int expected_draw = rand();
+    srand(77);
+    ArrivalSchedule *schedule = schedule_build(cfg);
+    ASSERT(schedule != NULL, 1, "schedule_build() != NULL");
+    ASSERT(rand(), expected_draw, "rand() state untouched");
+    ArrivalSchedule *again = schedule_build(cfg);
+    ASSERT(again != NULL, 1, "second schedule_build() != NULL");
+    int same = 1;
+    for (int slot = 0; slot < schedule->count; slot++) {
+        same &= schedule->due_ns[slot] == again->due_ns[slot] &&
+                schedule->vehicle[slot] == again->vehicle[slot];
+    }
+    schedule_destroy(again);
+    ASSERT(same, 1, "seeded schedules are identical");
+    ASSERT(schedule->count, cfg.num_trucks + cfg.num_cars,
+           "schedule->count == num_trucks + num_cars");
+    int sorted = 1;
+    for (int slot = 1; slot < schedule->count; slot++) {
+        sorted &= schedule->due_ns[slot - 1] <= schedule->due_ns[slot];
+    }
+    ASSERT(sorted, 1, "due times ascend");
+    int last_truck =
+        class_vehicle_index(&cfg.classes, CLASS_TRUCK, cfg.num_trucks);
+    int slot = schedule_slot(schedule, last_truck);
+    ASSERT(schedule->vehicle[slot], cfg.num_cars + cfg.num_trucks - 1,
+           "slot of the last truck holds it");
+    int streamed = class_vehicle_index(&cfg.classes, CLASS_CAR,
+                                       cfg.num_cars + 1);
+    ASSERT(schedule_slot(schedule, streamed), -1, "streamed car has no slot");
+    schedule_destroy(schedule);
+    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
+}
+
+void test_scenario() {
+    char path[] = "/tmp/ferry-scenario-XXXXXX";
+    int fd = mkstemp(path);
+    FILE *file = fd == -1 ? NULL : fdopen(fd, "w");
+    ASSERT(file != NULL, 1, "scenario file created");
+    fprintf(file, "# test load\n"
+                  "backlog 0 0 5 2 port1=100\n"
+                  "\n"
+                  "poisson 1000 3000 20 5 port1=0 ramp=1:9\n"
+                  "burst 3000 4000 10 0 size=4\n");
+    fclose(file);
+    char path_arg[64];
+    snprintf(path_arg, sizeof(path_arg), "--scenario=%s", path);
+    const char *argv[] = {"program", "0", "0", "5", "0", "10", path_arg,
+                          "--seed=4", "--dispatch=0", "--check"};
+    Config cfg;
+    int result = parse_config(10, argv, &cfg);
+    ASSERT(result, EXIT_SUCCESS, "result == EXIT_SUCCESS");
+    ASSERT(cfg.scenario.count, 3, "scenario.count == 3");
+    ASSERT(cfg.num_cars, 35, "num_cars == 35");
+    ASSERT(cfg.num_trucks, 7, "num_trucks == 7");
+
+    ArrivalSchedule *schedule = schedule_build(cfg);
+    ASSERT(schedule != NULL, 1, "schedule_build() != NULL");
+    int backlog = 0;
+    int in_segment = 1;
+    for (int slot = 0; slot < schedule->count; slot++) {
+        long long due_us = schedule->due_ns[slot] / NS_PER_US;
+        if (due_us == 0) {
+            backlog += schedule->port[slot] == 1;
+        } else if (due_us < 3000) {
+            in_segment &= due_us >= 1000 && schedule->port[slot] == 0;
+        } else {
+            // Three bursts of at most four cars
+            in_segment &= due_us == 3000 || due_us == 3333 || due_us == 3666;
+        }
+    }
+    ASSERT(backlog, 7, "backlog queued at port 1 at t=0");
+    ASSERT(in_segment, 1, "arrivals stay in their segments");
+    schedule_destroy(schedule);
+
+    // Vehicles sleep until their due times without the dispatcher
+    FerrySim *sim = ferry_sim_create(&cfg, sink_none());
+    ASSERT(sim != NULL, 1, "ferry_sim_create() != NULL");
+    result = ferry_sim_run(sim);
+    ASSERT(result, EXIT_SUCCESS, "scenario run == EXIT_SUCCESS");
+    ASSERT(ferry_sim_count_vehicles(sim, VEHICLE_CROSSED, VEHICLE_ANY), 42,
+           "every scenario vehicle crossed");
+    result = ferry_sim_destroy(sim);
+    ASSERT(result, EXIT_SUCCESS, "destroy == EXIT_SUCCESS");
+
+    unlink(path);
+    const char *argv_missing[] = {"program", "0", "0", "5", "0", "10",
+                                  "--scenario=/nonexistent/scenario"};
+    result = parse_config(7, argv_missing, &cfg);
+    ASSERT(result, EXIT_FAILURE, "missing scenario == EXIT_FAILURE");
+    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
+}
+
+void test_online_checker() {
+    Config cfg;
+    sim_test_config(&cfg, 9);
+    cfg.check = 1;
+    FerrySim *sim = ferry_sim_create(&cfg, sink_none());
+    ASSERT(sim != NULL, 1, "ferry_sim_create() != NULL");
+    int result = ferry_sim_run(sim);
+    ASSERT(result, EXIT_SUCCESS, "checked run == EXIT_SUCCESS");
+    ASSERT(sim->shared->check_failed, 0, "check_failed == 0");
+    result = ferry_sim_destroy(sim);
+    ASSERT(result, EXIT_SUCCESS, "destroy == EXIT_SUCCESS");
+
+    // Feed a violation by hand: a car boards before it arrived
+    cfg.num_trucks = 0;
+    cfg.num_cars = 1;
+    config_validate(&cfg);
+    SharedData *shared = init_shared_data(cfg);
+    ASSERT(shared != NULL, 1, "init_shared_data() != NULL");
+    publish_event(shared, 1, 'P', 0, "started", -1);
+    publish_event(shared, 2, 'O', 1, "started", -1);
+    publish_event(shared, 3, 'P', 0, "arrived to", 0);
+    publish_event(shared, 4, 'O', 1, "boarding", -1);
+    fprintf(stderr, "(expected violation follows)\n");
+    checker_process(shared, cfg);
+    ASSERT(shared->check_failed, 1, "check_failed == 1");
+    ASSERT((int)shared->events->read, 4, "checker stopped at the violation");
+    result = cleanup(shared);
+    ASSERT(result, EXIT_SUCCESS, "cleanup == EXIT_SUCCESS");
+    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
+}
+
+void test_aborted_run() {
+    char live_name[64];
+    snprintf(live_name, sizeof(live_name), "/ferry-test-live-%d", getpid());
+
+    // A checker failure stops the publisher as well
+    Config cfg;
+    sim_test_config(&cfg, 1);
+    cfg.num_trucks = 0;
+    cfg.num_cars = 1;
+    cfg.check = 1;
+    config_validate(&cfg);
+    SharedData *shared = init_shared_data(cfg);
+    ASSERT(shared != NULL, 1, "init_shared_data() != NULL");
+    LiveStats *live = live_stats_create(live_name);
+    ASSERT(live != NULL, 1, "live_stats_create() != NULL");
+    pid_t publisher = create_publisher_process(shared, cfg, live);
+    publish_event(shared, 1, 'P', 0, "started", -1);
+    publish_event(shared, 2, 'O', 1, "boarding", -1);
+    fprintf(stderr, "(expected violation follows)\n");
+    checker_process(shared, cfg);
+    ASSERT(shared->aborted, 1, "aborted after the violation");
+    long long deadline = now_ns() + 2 * NS_PER_SEC;
+    pid_t reaped = 0;
+    while (reaped == 0 && now_ns() < deadline) {
+        reaped = waitpid(publisher, NULL, WNOHANG);
+        usleep(1000);
+    }
+    if (reaped == 0) {
+        kill(publisher, SIGKILL);
+        waitpid(publisher, NULL, 0);
+    }
+    ASSERT(reaped, publisher, "publisher stopped with the run");
+    live_stats_destroy(live, live_name);
+    int result = cleanup(shared);
+    ASSERT(result, EXIT_SUCCESS, "cleanup == EXIT_SUCCESS");
+
+    // A ferry killed mid-run does not leave the helpers waiting
+    sim_test_config(&cfg, 2);
+    cfg.num_cars = 2000;
+    cfg.max_vehicle_arrival_us = 10000;
+    cfg.max_ferry_arrival_us = 1000;
+    cfg.check = 1;
+    cfg.live_stats_name = live_name;
+    FerrySim *sim = ferry_sim_create(&cfg, sink_none());
+    ASSERT(sim != NULL, 1, "ferry_sim_create() != NULL");
+    pid_t killer = fork();
+    if (killer == 0) {
+        while (__atomic_load_n(&sim->shared->sim_pgid, __ATOMIC_ACQUIRE) == 0) {
+            usleep(100);
+        }
+        usleep(20000);
+        kill(-sim->shared->sim_pgid, SIGKILL);
+        _exit(EXIT_SUCCESS);
+    }
+    long long start = now_ns();
+    fprintf(stderr, "(expected ferry exit follows)\n");
+    result = ferry_sim_run(sim);
+    ASSERT(result, EXIT_FAILURE, "killed run == EXIT_FAILURE");
+    ASSERT(sim->shared->aborted, 1, "killed run is aborted");
+    ASSERT(now_ns() - start < 5 * NS_PER_SEC, 1, "helpers stopped");
+    result = ferry_sim_destroy(sim);
+    ASSERT(result, EXIT_SUCCESS, "destroy == EXIT_SUCCESS");
+    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
+}
+
+void test_vehicle_classes() {
+    const char *argv[] = {"program", "2", "3", "6", "0", "10",
+                          "--classes=bus:B:5:3,moto:M:1:4:50:2", "--seed=7",
+                          "--check"};
+    Config cfg;
+    int result = parse_config(9, argv, &cfg);
+    ASSERT(result, EXIT_SUCCESS, "result == EXIT_SUCCESS");
+    ASSERT(cfg.classes.count, 4, "classes.count == 4");
+    ASSERT(cfg.classes.vehicles, 12, "classes.vehicles == 12");
+    int moto = class_find(&cfg.classes, 'M');
+    ASSERT(moto, 3, "class_find('M') == 3");
+    ASSERT(cfg.classes.classes[moto].weight, 2, "moto weight == 2");
+    ASSERT(cfg.classes.min_size, 1, "min_size == 1");
+    ASSERT(class_vehicle_index(&cfg.classes, moto, 1), 8,
+           "first moto follows the buses");
+    int id;
+    ASSERT(class_of_vehicle(&cfg.classes, 7, &id), 2, "vehicle 7 is a bus");
+    ASSERT(id, 3, "vehicle 7 is bus 3");
+
+    FerrySim *sim = ferry_sim_create(&cfg, sink_none());
+    ASSERT(sim != NULL, 1, "ferry_sim_create() != NULL");
+    result = ferry_sim_run(sim);
+    ASSERT(result, EXIT_SUCCESS, "run with classes == EXIT_SUCCESS");
+    ASSERT(ferry_sim_count_vehicles(sim, VEHICLE_CROSSED, VEHICLE_ANY), 12,
+           "every vehicle crossed");
+    // Live stats carry the waiting vehicles of every class
+    LiveStats live;
+    memset(&live, 0, sizeof(live));
+    long long last_actions = 0;
+    sim->shared->waiting[moto][1] = 2;
+    live_stats_sample(&live, sim->shared, &last_actions);
+    ASSERT(live.classes, 4, "live classes == 4");
+    ASSERT(live.class_letter[moto], 'M', "live letter of moto == 'M'");
+    ASSERT(strcmp(live.class_name[moto], "moto"), 0, "live name == moto");
+    ASSERT(live.waiting[moto][1], 2, "live waiting motos == 2");
+    sim->shared->waiting[moto][1] = 0;
+    result = ferry_sim_destroy(sim);
+    ASSERT(result, EXIT_SUCCESS, "destroy == EXIT_SUCCESS");
+
+    const char *invalid[] = {"--classes=bus:B:7:1", "--classes=bus:O:2:1",
+                             "--classes=bus:B:2", "--classes=bus:b:2:1"};
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        const char *argv_invalid[] = {"program", "2", "3", "6", "0", "10",
+                                      invalid[i]};
+        result = parse_config(7, argv_invalid, &cfg);
+        ASSERT(result, EXIT_FAILURE, "invalid class == EXIT_FAILURE");
+    }
+    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
+}
+
+void test_queue_limit() {
+    Config cfg;
+    sim_test_config(&cfg, 3);
+    cfg.num_trucks = 10;
+    cfg.num_cars = 50;
+    cfg.max_vehicle_arrival_us = 0;
+    cfg.queue_limit = 4;
+    cfg.check = 1;
+    FerrySim *sim = ferry_sim_create(&cfg, sink_none());
+    ASSERT(sim != NULL, 1, "ferry_sim_create() != NULL");
+    int result = ferry_sim_run(sim);
+    ASSERT(result, EXIT_SUCCESS, "limited run == EXIT_SUCCESS");
+    ASSERT(ferry_sim_count_vehicles(sim, VEHICLE_CROSSED, VEHICLE_ANY), 60,
+           "every vehicle crossed");
+    ASSERT(sim->shared->peak_waiting[0] <= 4 && sim->shared->peak_waiting[1] <= 4,
+           1, "queues stay within the limit");
+    FerryStats stats;
+    ferry_sim_stats(sim, &stats);
+    ASSERT(stats.refused > 0, 1, "stats.refused > 0");
+    result = ferry_sim_destroy(sim);
+    ASSERT(result, EXIT_SUCCESS, "destroy == EXIT_SUCCESS");
+    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
+}
+
+void test_unload_order() {
+    Deck deck;
+    deck_init(&deck, UNLOAD_LIFO, 2);
+    for (int entry = 0; entry < 5; entry++) {
+        deck_park(&deck, entry);
+    }
+    // Back positions first, the lanes in turn
+    int expected[] = {4, 2, 3, 0, 1};
+    int slot = deck_plan_unload(&deck);
+    int ordered = 1;
+    for (int i = 0; i < 5; i++) {
+        ordered &= slot == expected[i];
+        slot = slot == DECK_NONE ? DECK_NONE : deck.next[slot];
+    }
+    ASSERT(ordered && slot == DECK_NONE, 1, "lifo over 2 lanes");
+
+    // A fifo run leaves every deck in the boarding order
+    FerrySink log;
+    int result = sink_open_memory(&log, SIM_TEST_LOG_LEN);
+    ASSERT(result, EXIT_SUCCESS, "sink_open_memory() == EXIT_SUCCESS");
+    Config cfg;
+    sim_test_config(&cfg, 6);
+    cfg.num_trucks = 5;
+    cfg.num_cars = 30;
+    cfg.capacity_of_ferry = 10;
+    FerrySim *sim = ferry_sim_create(&cfg, log);
+    ASSERT(sim != NULL, 1, "ferry_sim_create() != NULL");
+    result = ferry_sim_run(sim);
+    ASSERT(result, EXIT_SUCCESS, "fifo run == EXIT_SUCCESS");
+    result = ferry_sim_destroy(sim);
+    ASSERT(result, EXIT_SUCCESS, "destroy == EXIT_SUCCESS");
+
+    size_t len;
+    const char *text = sink_text(&log, &len);
+    FILE *in = fmemopen((void *)text, len, "r");
+    char line[EVENT_LINE_LEN * 2];
+    Event boarded[MAX_DECK_SLOTS];
+    int count = 0;
+    int next = 0;
+    int in_order = 1;
+    while (fgets(line, sizeof(line), in)) {
+        Event event;
+        if (parse_event_line(line, &event) != EXIT_SUCCESS) {
+            continue;
+        }
+        if (event.action == EVENT_BOARDING) {
+            if (next > 0) {
+                count = 0;  // A new deck
+                next = 0;
+            }
+            boarded[count++] = event;
+        } else if (event.action == EVENT_LEAVING_IN) {
+            in_order &= next < count && boarded[next].type == event.type &&
+                        boarded[next].id == event.id;
+            next++;
+        }
+    }
+    fclose(in);
+    sink_close(&log);
+    ASSERT(in_order, 1, "vehicles leave in boarding order");
+
+    const char *argv[] = {"program", "1", "1", "5", "0", "10",
+                          "--unload=random"};
+    result = parse_config(7, argv, &cfg);
+    ASSERT(result, EXIT_FAILURE, "unknown unload order == EXIT_FAILURE");
+    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
+}
+
+void test_sleep_overshoot() {
+    Config cfg;
+    sim_test_config(&cfg, 8);
+    cfg.num_cars = 20;
+    cfg.max_vehicle_arrival_us = 500;
+    cfg.max_ferry_arrival_us = 200;
+    cfg.dispatch = 0;
+    cfg.timer_slack_ns = 1000;
+    FerrySim *sim = ferry_sim_create(&cfg, sink_none());
+    ASSERT(sim != NULL, 1, "ferry_sim_create() != NULL");
+    int result = ferry_sim_run(sim);
+    ASSERT(result, EXIT_SUCCESS, "run with timer slack == EXIT_SUCCESS");
+    ASSERT(sim->shared->overshoot[SLEEP_CROSSING].total > 0, 1,
+           "crossings are measured");
+    ASSERT(sim->shared->overshoot[SLEEP_ARRIVAL].total > 0, 1,
+           "arrivals are measured");
+    result = ferry_sim_destroy(sim);
+    ASSERT(result, EXIT_SUCCESS, "destroy == EXIT_SUCCESS");
+
+    // Absolute deadlines: time already spent counts toward the sleep
+    long long start = now_ns();
+    ASSERT(sleep_until(start - NS_PER_MS) >= NS_PER_MS, 1,
+           "past deadline returns at once, late");
+    long long late = sleep_until(start + 200 * NS_PER_US);
+    ASSERT(now_ns() - start >= 200 * NS_PER_US, 1, "slept to the deadline");
+    ASSERT(late >= 0, 1, "overshoot >= 0");
+    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
+}
+
+void test_port_links() {
+    const char *modes[] = {"unix", "tcp"};
+    for (size_t i = 0; i < sizeof(modes) / sizeof(modes[0]); i++) {
+        Config cfg;
+        sim_test_config(&cfg, 9);
+        cfg.num_trucks = 6;
+        cfg.num_cars = 20;
+        cfg.ports_name = modes[i];
+        cfg.queue_limit = 2;
+        cfg.check = 1;
+        FerrySim *sim = ferry_sim_create(&cfg, sink_none());
+        ASSERT(sim != NULL, 1, "ferry_sim_create() != NULL");
+        int result = ferry_sim_run(sim);
+        ASSERT(result, EXIT_SUCCESS, "run over port links == EXIT_SUCCESS");
+        ASSERT(ferry_sim_count_vehicles(sim, VEHICLE_CROSSED, VEHICLE_ANY), 26,
+               "every vehicle crossed");
+        ASSERT(sim->shared->port_messages[0] > 0 &&
+                   sim->shared->port_messages[1] > 0,
+               1, "both ports served over the link");
+        // Seven messages per crossing between a vehicle and its server
+        ASSERT(sim->shared->port_messages[0] + sim->shared->port_messages[1] >
+                   7 * 26,
+               1, "vehicle messages counted");
+        ASSERT(sim->shared->peak_waiting[0] <= 2 &&
+                   sim->shared->peak_waiting[1] <= 2,
+               1, "servers kept the queue limit");
+        result = ferry_sim_destroy(sim);
+        ASSERT(result, EXIT_SUCCESS, "destroy == EXIT_SUCCESS");
+    }
+
+    // A lost port server aborts the run instead of stalling the ferry
+    Config cfg;
+    sim_test_config(&cfg, 9);
+    cfg.num_cars = 2000;
+    cfg.max_vehicle_arrival_us = 10000;
+    cfg.ports_name = "unix";
+    FerrySim *sim = ferry_sim_create(&cfg, sink_none());
+    ASSERT(sim != NULL, 1, "ferry_sim_create() != NULL");
+    pid_t killer = fork();
+    if (killer == 0) {
+        while (__atomic_load_n(&sim->shared->port_messages[1],
+                               __ATOMIC_ACQUIRE) == 0) {
+            usleep(100);
+        }
+        kill(sim->shared->port_pid[0], SIGKILL);
+        _exit(EXIT_SUCCESS);
+    }
+    long long start = now_ns();
+    fprintf(stderr, "(expected lost link follows)\n");
+    int result = ferry_sim_run(sim);
+    ASSERT(result, EXIT_FAILURE, "lost link == EXIT_FAILURE");
+    ASSERT(sim->shared->aborted, 1, "lost link aborts the run");
+    ASSERT(now_ns() - start < 5 * NS_PER_SEC, 1, "ferry did not stall");
+    result = ferry_sim_destroy(sim);
+    ASSERT(result, EXIT_SUCCESS, "destroy == EXIT_SUCCESS");
+
+    const char *argv[] = {"program", "1", "1", "5", "0", "10",
+                          "--ports=pipe"};
+    result = parse_config(7, argv, &cfg);
+    ASSERT(result, EXIT_FAILURE, "unknown port link == EXIT_FAILURE");
+    ASSERT(port_link_find("tcp"), PORT_LINK_TCP, "port_link_find(tcp)");
+    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
+}
+
+void test_round_trips() {
+    Config cfg;
+    sim_test_config(&cfg, 10);
+    cfg.num_trucks = 4;
+    cfg.num_cars = 12;
+    cfg.round_trips = 2;
+    cfg.dwell_us = 300;
+    cfg.check = 1;
+    FerrySim *sim = ferry_sim_create(&cfg, sink_none());
+    ASSERT(sim != NULL, 1, "ferry_sim_create() != NULL");
+    int result = ferry_sim_run(sim);
+    ASSERT(result, EXIT_SUCCESS, "run with round trips == EXIT_SUCCESS");
+    ASSERT(ferry_sim_count_vehicles(sim, VEHICLE_CROSSED, VEHICLE_ANY), 16,
+           "every vehicle crossed");
+    ASSERT((int)sim->shared->total_vehicles_unloaded, 64,
+           "four crossings per vehicle");
+    ASSERT(sim->shared->overshoot[SLEEP_DWELL].total > 0, 1,
+           "dwells are measured");
+    result = ferry_sim_destroy(sim);
+    ASSERT(result, EXIT_SUCCESS, "destroy == EXIT_SUCCESS");
+
+    // The way back has to start where the vehicle left the ferry
+    const char *log = "1: P: started\n2: O 1: started\n3: O 1: arrived to 0\n"
+                      "4: P: arrived to 0\n5: O 1: boarding\n6: P: leaving 0\n"
+                      "7: P: arrived to 1\n8: O 1: leaving in 1\n"
+                      "9: O 1: arrived to 0\n";
+    ClassTable classes;
+    class_table_builtin(&classes, 1, 0);
+    char error[INVARIANT_ERROR_LEN];
+    FILE *in = fmemopen((void *)log, strlen(log), "r");
+    result = invariant_check_file(in, &classes, 10, 2, error, sizeof(error));
+    fclose(in);
+    ASSERT(result, EXIT_FAILURE, "return to the wrong port is caught");
+    ASSERT(strstr(error, "wrong port") != NULL, 1, "error names the port");
+    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
+}
+
+void test_stream_ids() {
+    char path[] = "/tmp/ferry-stream-XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT(fd != -1, 1, "stream file created");
+    const char *requests = "O\nN 1\n# comment\nX\nO 0";
+    ssize_t written = write(fd, requests, strlen(requests));
+    ASSERT(written == (ssize_t)strlen(requests), 1, "stream file written");
+    close(fd);
+
+    Config cfg;
+    sim_test_config(&cfg, 12);
+    cfg.num_trucks = 1;
+    cfg.num_cars = 2;
+    cfg.stream_path = path;
+    FerrySim *sim = ferry_sim_create(&cfg, sink_none());
+    ASSERT(sim != NULL, 1, "ferry_sim_create() != NULL");
+    int result = ferry_sim_run(sim);
+    ASSERT(result, EXIT_SUCCESS, "streamed run == EXIT_SUCCESS");
+    ASSERT(ferry_sim_count_vehicles(sim, VEHICLE_CROSSED, VEHICLE_ANY), 6,
+           "batch and streamed vehicles crossed");
+    result = ferry_sim_destroy(sim);
+    ASSERT(result, EXIT_SUCCESS, "destroy == EXIT_SUCCESS");
+    unlink(path);
+
+    // Ids past the table still get a vehicle, it is just not tracked
+    ClassTable classes;
+    class_table_builtin(&classes, 1, 1);
+    VehicleTable *table = vehicle_table_create(&classes, 1);
+    ASSERT(table != NULL, 1, "streaming table created");
+    ASSERT(vehicle_table_index(table, CLASS_TRUCK, MAX_CLASS_VEHICLES) != -1,
+           1, "last id in the table is tracked");
+    ASSERT(vehicle_table_index(table, CLASS_CAR, MAX_CLASS_VEHICLES + 1), -1,
+           "ids past the table are untracked");
+    vehicle_table_destroy(table);
+
+    // and keeps a random stream of its own
+    unsigned int past = process_stream(CLASS_CAR, MAX_CLASS_VEHICLES + 1);
+    ASSERT(past != process_stream(CLASS_TRUCK, 1), 1,
+           "past the table does not reuse the next class");
+    ASSERT(past != process_stream(MAX_VEHICLE_CLASSES - 1, MAX_CLASS_VEHICLES),
+           1, "past the table does not reuse the last class");
+    ASSERT(past != process_stream(CLASS_TRUCK, MAX_CLASS_VEHICLES + 1), 1,
+           "classes past the table stay apart");
+    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
+}
+
+void test_trace() {
+    char path[] = "/tmp/ferry-trace-XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT(fd != -1, 1, "trace file created");
+    close(fd);
+    Config cfg;
+    sim_test_config(&cfg, 11);
+    cfg.num_trucks = 3;
+    cfg.num_cars = 9;
+    cfg.trace_path = path;
+    FerrySim *sim = ferry_sim_create(&cfg, sink_none());
+    ASSERT(sim != NULL, 1, "ferry_sim_create() != NULL");
+    int result = ferry_sim_run(sim);
+    ASSERT(result, EXIT_SUCCESS, "traced run == EXIT_SUCCESS");
+    result = ferry_sim_destroy(sim);
+    ASSERT(result, EXIT_SUCCESS, "destroy == EXIT_SUCCESS");
+
+    // One event per line between the brackets of a JSON array
+    FILE *in = fopen(path, "r");
+    ASSERT(in != NULL, 1, "trace written");
+    char line[TRACE_EVENT_LEN * 2];
+    int lines = 0;
+    int events = 1;
+    int waits = 0;
+    int phases[PHASE_COUNT] = {0};
+    const char *last = "";
+    while (fgets(line, sizeof(line), in)) {
+        if (lines++ > 0 && strcmp(line, "]\n") != 0) {
+            events &= line[0] == '{';
+        }
+        waits += strstr(line, "\"name\":\"waiting\",\"ph\":\"X\",\"pid\":2") != NULL;
+        for (int phase = 0; phase < PHASE_COUNT; phase++) {
+            char name[TRACE_NAME_LEN * 2];
+            snprintf(name, sizeof(name), "\"name\":\"%s\",\"ph\":\"X\",\"pid\":1",
+                     trip_phase_name(phase));
+            phases[phase] += strstr(line, name) != NULL;
+        }
+        last = strcmp(line, "]\n") == 0 ? "]" : "";
+    }
+    fclose(in);
+    unlink(path);
+    ASSERT(events && strcmp(last, "]") == 0, 1, "trace is a JSON array");
+    ASSERT(waits, 12, "one wait span per vehicle");
+    ASSERT(phases[PHASE_CROSSING] > 0 && phases[PHASE_LOADING] > 0 &&
+               phases[PHASE_WAITING] > 0,
+           1, "ferry phases traced");
+
+    cfg.trace_path = "/nonexistent/trace.json";
+    sim = ferry_sim_create(&cfg, sink_none());
+    ASSERT(sim != NULL, 1, "ferry_sim_create() != NULL");
+    result = ferry_sim_run(sim);
+    ASSERT(result, EXIT_FAILURE, "unwritable trace == EXIT_FAILURE");
+    ferry_sim_destroy(sim);
+    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
+}
+
+void test_simulation_invalid_config() {
+    Config cfg;
+    sim_test_config(&cfg, 1);
+    cfg.policy_name = "random";
+    FerrySim *sim = ferry_sim_create(&cfg, sink_none());
+    ASSERT(sim == NULL, 1, "ferry_sim_create() == NULL");
+    printf("\033[32mTest '%s' passed.\033[0m\n", __func__); // Print success message in green
+}
+
+int run_simulation_tests() {
+    init_log("simulation_tests.log");
+
+    printf("\033[34mRunning simulation tests...\033[0m\n");
+    test_simulation_logs_are_valid();
+    test_simulation_stats();
+    test_simulation_idle_park();
+    test_arrival_schedule();
+    test_scenario();
+    test_online_checker();
+    test_aborted_run();
+    test_vehicle_classes();
+    test_queue_limit();
+    test_unload_order();
+    test_sleep_overshoot();
+    test_port_links();
+    test_round_trips();
+    test_stream_ids();
+    test_trace();
+    test_simulation_invalid_config();
+
+    close_log();
+    return report_test_summary();
+}
+
+// --- Performance tests, seeded scenarios against a checked-in baseline ---
+#define PERF_RUNS 3             // Best of, to ride out scheduler noise
+#define PERF_TOLERANCE_PCT 50   // Allowed slowdown over the baseline
+#define PERF_NAME_LEN 64
+
+typedef struct {
+    char name[PERF_NAME_LEN];
+    int trucks, cars, capacity, vehicle_us, ferry_us;
+    int wall_ms;           // Baseline wall time of the run
+    int ns_per_action;     // Baseline cost of one logged action
+} PerfScenario;
+
+// Returns the budget of a baseline value
+int perf_limit(int baseline) {
+    return baseline + baseline * PERF_TOLERANCE_PCT / 100;
+}
+
+// Runs one scenario PERF_RUNS times and checks the fastest run
+void test_perf_scenario(const PerfScenario *scenario) {
+    long long best_ns = 0;
+    long long actions = 0;
+    for (int run = 0; run < PERF_RUNS; run++) {
+        Config cfg;
+        config_defaults(&cfg);
+        cfg.num_trucks = scenario->trucks;
+        cfg.num_cars = scenario->cars;
+        cfg.capacity_of_ferry = scenario->capacity;
+        cfg.max_vehicle_arrival_us = scenario->vehicle_us;
+        cfg.max_ferry_arrival_us = scenario->ferry_us;
+        cfg.seed = 1;
+        FerrySim *sim = ferry_sim_create(&cfg, sink_none());
+        ASSERT(sim != NULL, 1, "ferry_sim_create() != NULL");
+        int result = ferry_sim_run(sim);
+        ASSERT(result, EXIT_SUCCESS, "result == EXIT_SUCCESS");
+        FerryStats stats;
+        ferry_sim_stats(sim, &stats);
+        result = ferry_sim_destroy(sim);
+        ASSERT(result, EXIT_SUCCESS, "destroy == EXIT_SUCCESS");
+        ASSERT((int)stats.vehicles, cfg.num_trucks + cfg.num_cars,
+               "stats.vehicles == num_trucks + num_cars");
+        if (run == 0 || stats.elapsed_ns < best_ns) {
+            best_ns = stats.elapsed_ns;
+            actions = stats.actions;
+        }
+    }
+
+    int wall_ms = (int)(best_ns / NS_PER_MS);
+    int ns_per_action = actions > 0 ? (int)(best_ns / actions) : 0;
+    printf("  %-24s %6d ms (baseline %6d) %7d ns/action (baseline %7d)\n",
+           scenario->name, wall_ms, scenario->wall_ms, ns_per_action,
+           scenario->ns_per_action);
+    ASSERT_AT_MOST(wall_ms, perf_limit(scenario->wall_ms),
+                   "wall ms <= baseline + tolerance");
+    ASSERT_AT_MOST(ns_per_action, perf_limit(scenario->ns_per_action),
+                   "ns per action <= baseline + tolerance");
+    printf("\033[32mTest '%s' passed for %s.\033[0m\n", __func__,
+           scenario->name); // Print success message in green
+}
+
+// Runs every scenario of the baseline file
+int run_perf_tests(const char *baseline_path) {
+    FILE *baseline = fopen(baseline_path, "r");
+    if (baseline == NULL) {
+        fprintf(stderr, "[ERROR] Failed to open %s\n", baseline_path);
+        return 1;
+    }
+    init_log("perf_tests.log");
+
+    printf("\033[34mRunning performance tests (best of %d, +%d%%)...\033[0m\n",
+           PERF_RUNS, PERF_TOLERANCE_PCT);
+    char line[256];
+    while (fgets(line, sizeof(line), baseline) != NULL) {
+        PerfScenario scenario;
+        if (line[0] == '#' || line[0] == '\n') {
+            continue;
+        }
+        if (sscanf(line, "%63s %d %d %d %d %d %d %d", scenario.name,
+                   &scenario.trucks, &scenario.cars, &scenario.capacity,
+                   &scenario.vehicle_us, &scenario.ferry_us,
+                   &scenario.wall_ms, &scenario.ns_per_action) != 8) {
+            fprintf(stderr, "[ERROR] Malformed baseline line: %s", line);
+            tests_failed++;
+            continue;
+        }
+        test_perf_scenario(&scenario);
+    }
+    fclose(baseline);
+
+    close_log();
+    return report_test_summary();
+}
+
+int run_all_tests() {
+    int failed = run_args_test();
+    failed += run_simulation_tests();
+    return failed;
 }
\ No newline at end of file
@@ -0,0 +1,64 @@
+#!/bin/sh
+# Sweeps the departure rules and hold times on one seeded workload and
+# prints the crossings vs latency frontier.
+#
+# Rows marked with * are on the frontier: no other row has both fewer
+# trips per second and a lower transit p99. The default workload is
+# off-peak, where holding saves the most crossings.
+#
+# Usage: tools/bench_departure.sh [trucks cars capacity vehicle_us ferry_us]
+#        [--seed=N] [--min-fill=P] [--bin=path]
+
+BIN=build/main
+SEED=1
+MIN_FILL=100
+ARGS=""
+HOLDS_US="0 100 250 500 1000 2500 5000"
+
+for arg in "$@"; do
+    case "$arg" in
+        --seed=*) SEED="${arg#--seed=}" ;;
+        --min-fill=*) MIN_FILL="${arg#--min-fill=}" ;;
+        --bin=*) BIN="${arg#--bin=}" ;;
+        *) ARGS="$ARGS $arg" ;;
+    esac
+done
+[ -n "$ARGS" ] || ARGS="100 300 20 10000 200"
+BIN=$(realpath "$BIN") || exit 1
+TOOLS=$(dirname "$(realpath "$0")")
+
+WORK=$(mktemp -d /tmp/ferry-bench-XXXXXX) || exit 1
+trap 'rm -rf "$WORK"' EXIT
+cd "$WORK" || exit 1
+
+echo "workload:$ARGS --seed=$SEED --min-fill=$MIN_FILL"
+for rule in hold ewma; do
+    for hold in $HOLDS_US; do
+        depart="--depart=$rule"
+        [ "$hold" -eq 0 ] && depart="--depart=immediate"
+        # shellcheck disable=SC2086
+        "$BIN" $ARGS --seed="$SEED" $depart --hold-us="$hold" \
+            --min-fill="$MIN_FILL" --stats 2>stats.txt >/dev/null ||
+            { echo "$rule $hold: run failed"; exit 1; }
+        echo "$rule $hold $(awk -f "$TOOLS/stats_row.awk" stats.txt)"
+    done
+done | awk '
+    { rule[NR] = $1; hold[NR] = $2; trips[NR] = $9; rate[NR] = $4
+      fill[NR] = $5; p50[NR] = $7; p99[NR] = $8 }
+    END {
+        printf "  %-6s %8s %7s %9s %7s %9s %9s\n", "rule", "hold-us",
+               "trips", "trips/s", "fill", "trans-p50", "trans-p99"
+        for (i = 1; i <= NR; i++) {
+            front = "*"
+            for (j = 1; j <= NR; j++) {
+                if (rate[j] <= rate[i] && p99[j] <= p99[i] &&
+                    (rate[j] < rate[i] || p99[j] < p99[i])) {
+                    front = " "
+                }
+            }
+            printf "%s %-6s %8d %7d %9.1f %6.1f%% %9.3f %9.3f\n", front,
+                   rule[i], hold[i], trips[i], rate[i], fill[i], p50[i],
+                   p99[i]
+        }
+        print "latencies in ms"
+    }'
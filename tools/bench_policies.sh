@@ -0,0 +1,56 @@
+#!/bin/sh
+# Compares the boarding policies on the same seeded workload.
+#
+# Every policy runs the same arguments and --seed, so the vehicles arrive
+# at the same times and only the boarding order differs. Prints one row
+# per policy with throughput and wait-to-board / transit tail latency.
+#
+# Usage: tools/bench_policies.sh [trucks cars capacity vehicle_us ferry_us]
+#        [--seed=N] [--runs=N] [--bin=path]
+
+BIN=build/main
+SEED=1
+RUNS=3
+ARGS=""
+POLICIES="alternate fifo trucks-first longest-waiting wfq"
+
+for arg in "$@"; do
+    case "$arg" in
+        --seed=*) SEED="${arg#--seed=}" ;;
+        --runs=*) RUNS="${arg#--runs=}" ;;
+        --bin=*) BIN="${arg#--bin=}" ;;
+        *) ARGS="$ARGS $arg" ;;
+    esac
+done
+[ -n "$ARGS" ] || ARGS="1000 3000 20 2000 200"
+BIN=$(realpath "$BIN") || exit 1
+TOOLS=$(dirname "$(realpath "$0")")
+
+WORK=$(mktemp -d /tmp/ferry-bench-XXXXXX) || exit 1
+trap 'rm -rf "$WORK"' EXIT
+cd "$WORK" || exit 1
+
+echo "workload:$ARGS --seed=$SEED, best of $RUNS runs"
+printf "%-16s %10s %9s %9s %9s %9s %9s\n" policy veh/s trips/s fill \
+    wait-p99 trans-p50 trans-p99
+for policy in $POLICIES; do
+    best=""
+    run=0
+    while [ "$run" -lt "$RUNS" ]; do
+        # shellcheck disable=SC2086
+        "$BIN" $ARGS --seed="$SEED" --policy="$policy" --stats \
+            2>stats.txt >/dev/null || { echo "$policy: run failed"; exit 1; }
+        row=$(awk -f "$TOOLS/stats_row.awk" stats.txt | awk -v p="$policy" \
+            '{ printf "%-16s %10.1f %9.1f %8.1f%% %9.3f %9.3f %9.3f\n",
+                      p, $1, $2, $3, $4, $5, $6 }')
+        rate=$(echo "$row" | awk '{ print $2 }')
+        best_rate=$(echo "$best" | awk '{ print $2 + 0 }')
+        if [ -z "$best" ] || awk -v a="$rate" -v b="$best_rate" \
+            'BEGIN { exit !(a > b) }'; then
+            best="$row"
+        fi
+        run=$((run + 1))
+    done
+    echo "$best"
+done
+echo "latencies in ms"
@@ -0,0 +1,201 @@
+/**
+ * ferrystat: prints live rates of a running simulation.
+ *
+ * Attaches read-only to the segment published with --live-stats=NAME and
+ * samples it with the seqlock reader, so it never blocks the simulation.
+ *
+ * Usage: ferrystat NAME [--interval-ms=N] [--prom=FILE] [--once]
+ */
+#include <fcntl.h>     // O_RDONLY
+#include <stdio.h>     // printf
+#include <string.h>    // strncmp
+#include <sys/mman.h>  // shm_open, mmap
+#include <unistd.h>    // usleep
+
+#include "main.h"
+
+// --- Defaults ---
+#define FERRYSTAT_DEFAULT_INTERVAL_MS 1000
+#define FERRYSTAT_PATH_LEN 4096
+
+// --- Structs ---
+typedef struct {
+    const char *name;      // Name of the stats segment
+    const char *prom_path; // Prometheus text file, NULL = off
+    int interval_ms;       // Time between printed lines
+    int once;              // Print a single snapshot and exit
+} FerrystatConfig;
+
+/**
+ * @brief Returns the largest sampled queue depth of a port
+ */
+static int history_peak(const LiveStats *stats, int port) {
+    int peak = 0;
+    for (int i = 0; i < stats->history_len; i++) {
+        if (stats->queue_history[i][port] > peak) {
+            peak = stats->queue_history[i][port];
+        }
+    }
+    return peak;
+}
+
+/**
+ * @brief Prints the waiting vehicles of every class at a port, e.g. "3/1/0"
+ */
+static void print_waiting(const LiveStats *stats, int port) {
+    for (int cls = 0; cls < stats->classes; cls++) {
+        printf("%s%d", cls > 0 ? "/" : "", stats->waiting[cls][port]);
+    }
+}
+
+/**
+ * @brief Prints one line of live rates
+ * @param now Current snapshot
+ * @param prev Previous snapshot, or NULL for the first line
+ */
+static void print_line(const LiveStats *now, const LiveStats *prev) {
+    double elapsed = (double)(now->updated_ns - now->start_ns) / NS_PER_SEC;
+    double unload_rate = 0.0;
+    double trip_rate = 0.0;
+    if (prev != NULL && now->updated_ns > prev->updated_ns) {
+        double seconds =
+            (double)(now->updated_ns - prev->updated_ns) / NS_PER_SEC;
+        unload_rate = (now->unloaded - prev->unloaded) / seconds;
+        trip_rate = (now->trips - prev->trips) / seconds;
+    }
+    printf("t=%7.2fs unloaded=%lld", elapsed, now->unloaded);
+    if (now->expected >= 0) {
+        printf("/%lld", now->expected);
+    }
+    printf(" %8.1f veh/s %7.1f trips/s %9.1f act/s | port %d deck %d/%d "
+           "| waiting ",
+           unload_rate, trip_rate, now->action_rate, now->ferry_port,
+           now->deck_units, now->capacity);
+    for (int cls = 0; cls < now->classes; cls++) {
+        printf("%s%c", cls > 0 ? "/" : "", now->class_letter[cls]);
+    }
+    printf(" p0 ");
+    print_waiting(now, 0);
+    printf(" p1 ");
+    print_waiting(now, 1);
+    printf(" (peak %d/%d)%s\n", history_peak(now, 0), history_peak(now, 1),
+           now->finished ? " finished" : "");
+    fflush(stdout);
+}
+
+/**
+ * @brief Writes a snapshot in Prometheus text format
+ * @param path Output file, replaced atomically
+ * @param stats Snapshot to export
+ * @return 0 if successful, -1 otherwise
+ */
+static int export_prometheus(const char *path, const LiveStats *stats) {
+    char tmp[FERRYSTAT_PATH_LEN];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    FILE *out = fopen(tmp, "w");
+    if (out == NULL) {
+        return -1;
+    }
+    fprintf(out, "# TYPE ferry_vehicles_unloaded_total counter\n");
+    fprintf(out, "ferry_vehicles_unloaded_total %lld\n", stats->unloaded);
+    fprintf(out, "# TYPE ferry_actions_total counter\n");
+    fprintf(out, "ferry_actions_total %lld\n", stats->actions);
+    fprintf(out, "# TYPE ferry_trips_total counter\n");
+    fprintf(out, "ferry_trips_total %lld\n", stats->trips);
+    fprintf(out, "# TYPE ferry_action_rate gauge\n");
+    fprintf(out, "ferry_action_rate %.3f\n", stats->action_rate);
+    fprintf(out, "# TYPE ferry_deck_units gauge\n");
+    fprintf(out, "ferry_deck_units %d\n", stats->deck_units);
+    fprintf(out, "# TYPE ferry_capacity_units gauge\n");
+    fprintf(out, "ferry_capacity_units %d\n", stats->capacity);
+    fprintf(out, "# TYPE ferry_port gauge\n");
+    fprintf(out, "ferry_port %d\n", stats->ferry_port);
+    fprintf(out, "# TYPE ferry_waiting_vehicles gauge\n");
+    for (int port = 0; port < 2; port++) {
+        for (int cls = 0; cls < stats->classes; cls++) {
+            fprintf(out, "ferry_waiting_vehicles{port=\"%d\",type=\"%s\"} %d\n",
+                    port, stats->class_name[cls], stats->waiting[cls][port]);
+        }
+    }
+    fprintf(out, "# TYPE ferry_finished gauge\n");
+    fprintf(out, "ferry_finished %d\n", stats->finished);
+    if (fclose(out) != 0) {
+        return -1;
+    }
+    return rename(tmp, path);
+}
+
+/**
+ * @brief Parses the command line
+ * @return 0 if successful, -1 otherwise
+ */
+static int parse_ferrystat_args(int argc, char *argv[], FerrystatConfig *fc) {
+    fc->name = NULL;
+    fc->prom_path = NULL;
+    fc->interval_ms = FERRYSTAT_DEFAULT_INTERVAL_MS;
+    fc->once = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--interval-ms=", 14) == 0) {
+            if (parse_uint(argv[i] + 14, 1, MAX_LIVE_INTERVAL_MS,
+                           "interval-ms", &fc->interval_ms)) {
+                return -1;
+            }
+        } else if (strncmp(argv[i], "--prom=", 7) == 0) {
+            fc->prom_path = argv[i] + 7;
+        } else if (strcmp(argv[i], "--once") == 0) {
+            fc->once = 1;
+        } else if (fc->name == NULL && argv[i][0] != '-') {
+            fc->name = argv[i];
+        } else {
+            return -1;
+        }
+    }
+    return fc->name == NULL ? -1 : 0;
+}
+
+int main(int argc, char *argv[]) {
+    FerrystatConfig fc;
+    if (parse_ferrystat_args(argc, argv, &fc) == -1) {
+        fprintf(stderr,
+                "Usage: %s NAME [--interval-ms=N] [--prom=FILE] [--once]\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+    int fd = shm_open(fc.name, O_RDONLY, 0);
+    if (fd == -1) {
+        fprintf(stderr, "[ERROR] No live stats segment %s\n", fc.name);
+        return EXIT_FAILURE;
+    }
+    const LiveStats *live =
+        mmap(NULL, sizeof(LiveStats), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (live == MAP_FAILED) {
+        fprintf(stderr, "[ERROR] mmap failed for %s\n", fc.name);
+        return EXIT_FAILURE;
+    }
+
+    LiveStats prev;
+    LiveStats now;
+    int have_prev = 0;
+    while (1) {
+        live_stats_read(live, &now);
+        if (now.version != LIVE_STATS_VERSION) {
+            fprintf(stderr, "[ERROR] Unsupported stats version %d\n",
+                    now.version);
+            return EXIT_FAILURE;
+        }
+        print_line(&now, have_prev ? &prev : NULL);
+        if (fc.prom_path != NULL && export_prometheus(fc.prom_path, &now)) {
+            fprintf(stderr, "[WARNING] Failed to write %s\n", fc.prom_path);
+        }
+        if (fc.once || now.finished) {
+            break;
+        }
+        prev = now;
+        have_prev = 1;
+        usleep(fc.interval_ms * 1000);
+    }
+    munmap((void *)live, sizeof(LiveStats));
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,331 @@
+/**
+ * Microbenchmarks of the primitives on the simulation's hot path.
+ *
+ * Every benchmark runs a warm-up batch and then a number of timed batches
+ * of the same size. A row reports the mean ns per operation over the
+ * batches with its standard deviation, minimum and maximum, so protocol
+ * changes can be costed before they are made.
+ *
+ * Usage: microbench [filter] [--samples=N] [--scale=N]
+ */
+#include <math.h>  // sqrt
+
+#include "ferry.h"
+
+// --- Defaults ---
+#define BENCH_DEFAULT_SAMPLES 10
+#define BENCH_MAX_SAMPLES 1000
+#define BENCH_MAX_SCALE 1000
+#define BENCH_MUTEX_WORKERS 4
+
+// --- Structs ---
+typedef long long (*BenchFn)(int iters, int arg);
+
+typedef struct {
+    const char *name;  // Row label, matched by the filter
+    BenchFn run;       // Runs iters operations, returns the elapsed ns
+    int arg;           // Benchmark parameter, e.g. number of writers
+    int iters;         // Operations per batch at scale 1
+} Bench;
+
+typedef struct {
+    int samples;          // Timed batches per benchmark
+    int scale;            // Multiplier of the batch sizes
+    const char *filter;   // Substring of the benchmarks to run, or NULL
+} BenchConfig;
+
+/**
+ * @brief Maps zeroed shared memory, exits on failure
+ */
+static void *map_shared(size_t size) {
+    void *mem = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) {
+        fprintf(stderr, "[ERROR] mmap failed\n");
+        exit(EXIT_FAILURE);
+    }
+    return mem;
+}
+
+/**
+ * @brief Forks a benchmark helper, exits on failure
+ */
+static pid_t fork_helper(void) {
+    pid_t pid = fork();
+    if (pid < 0) {
+        fprintf(stderr, "[ERROR] fork failed\n");
+        exit(EXIT_FAILURE);
+    }
+    return pid;
+}
+
+/**
+ * @brief Round trips of a pshared sem_t pair between two processes
+ */
+static long long bench_sem_ping_pong(int iters, int arg) {
+    (void)arg;
+    sem_t *sems = map_shared(2 * sizeof(sem_t));
+    sem_init(&sems[0], 1, 0);
+    sem_init(&sems[1], 1, 0);
+    if (fork_helper() == 0) {
+        for (int i = 0; i < iters; i++) {
+            sem_wait(&sems[0]);
+            sem_post(&sems[1]);
+        }
+        _exit(EXIT_SUCCESS);
+    }
+    long long start = now_ns();
+    for (int i = 0; i < iters; i++) {
+        sem_post(&sems[0]);
+        sem_wait(&sems[1]);
+    }
+    long long elapsed = now_ns() - start;
+    wait(NULL);
+    sem_destroy(&sems[0]);
+    sem_destroy(&sems[1]);
+    munmap(sems, 2 * sizeof(sem_t));
+    return elapsed;
+}
+
+/**
+ * @brief Round trips of an AdaptiveSem pair, arg is the spin budget
+ */
+static long long bench_adaptive_ping_pong(int iters, int arg) {
+    AdaptiveSem *sems = map_shared(2 * sizeof(AdaptiveSem));
+    adaptive_sem_init(&sems[0], 0, arg);
+    adaptive_sem_init(&sems[1], 0, arg);
+    if (fork_helper() == 0) {
+        for (int i = 0; i < iters; i++) {
+            adaptive_sem_wait(&sems[0]);
+            adaptive_sem_post(&sems[1]);
+        }
+        _exit(EXIT_SUCCESS);
+    }
+    long long start = now_ns();
+    for (int i = 0; i < iters; i++) {
+        adaptive_sem_post(&sems[0]);
+        adaptive_sem_wait(&sems[1]);
+    }
+    long long elapsed = now_ns() - start;
+    wait(NULL);
+    munmap(sems, 2 * sizeof(AdaptiveSem));
+    return elapsed;
+}
+
+/**
+ * @brief Acquire and release of a mutex semaphore shared by arg processes
+ */
+static long long bench_contended_mutex(int iters, int arg) {
+    typedef struct {
+        sem_t mutex;
+        sem_t start;
+        long long counter;
+    } MutexBench;
+    MutexBench *bench = map_shared(sizeof(MutexBench));
+    sem_init(&bench->mutex, 1, 1);
+    sem_init(&bench->start, 1, 0);
+    for (int worker = 0; worker < arg; worker++) {
+        if (fork_helper() == 0) {
+            sem_wait(&bench->start);
+            for (int i = 0; i < iters / arg; i++) {
+                sem_wait(&bench->mutex);
+                bench->counter++;
+                sem_post(&bench->mutex);
+            }
+            _exit(EXIT_SUCCESS);
+        }
+    }
+    long long start = now_ns();
+    for (int worker = 0; worker < arg; worker++) {
+        sem_post(&bench->start);
+    }
+    while (wait(NULL) > 0);
+    long long elapsed = now_ns() - start;
+    sem_destroy(&bench->mutex);
+    sem_destroy(&bench->start);
+    munmap(bench, sizeof(MutexBench));
+    return elapsed;
+}
+
+/**
+ * @brief Logged actions per second with arg writer processes
+ *
+ * The lines go to a temporary file, flushed per line like proj2.out.
+ */
+static long long bench_print_action(int iters, int arg) {
+    char path[] = "/tmp/ferry-microbench-XXXXXX";
+    int fd = mkstemp(path);
+    FILE *file = fd == -1 ? NULL : fdopen(fd, "w");
+    if (file == NULL) {
+        fprintf(stderr, "[ERROR] Failed to create %s\n", path);
+        exit(EXIT_FAILURE);
+    }
+    unlink(path);
+    Config cfg;
+    config_defaults(&cfg);
+    cfg.num_trucks = 0;
+    cfg.num_cars = 0;
+    cfg.capacity_of_ferry = MIN_CAPACITY_PARCEL;
+    FerrySink log = sink_file(file);
+    SharedData *shared = init_shared_data(cfg);
+    if (shared == NULL) {
+        exit(EXIT_FAILURE);
+    }
+
+    long long start = now_ns();
+    for (int writer = 1; writer <= arg; writer++) {
+        if (fork_helper() == 0) {
+            for (int i = 0; i < iters / arg; i++) {
+                print_action(shared, &log, 'O', writer, "boarding", -1);
+            }
+            _exit(EXIT_SUCCESS);
+        }
+    }
+    while (wait(NULL) > 0);
+    long long elapsed = now_ns() - start;
+    cleanup(shared);
+    fclose(file);
+    return elapsed;
+}
+
+/**
+ * @brief fork() and exit of a process that maps the simulation state
+ */
+static long long bench_fork_exit(int iters, int arg) {
+    (void)arg;
+    Config cfg;
+    config_defaults(&cfg);
+    cfg.num_trucks = 0;
+    cfg.num_cars = 0;
+    cfg.capacity_of_ferry = MIN_CAPACITY_PARCEL;
+    SharedData *shared = init_shared_data(cfg);
+    if (shared == NULL) {
+        exit(EXIT_FAILURE);
+    }
+    long long start = now_ns();
+    for (int i = 0; i < iters; i++) {
+        if (fork_helper() == 0) {
+            _exit(EXIT_SUCCESS);
+        }
+        wait(NULL);
+    }
+    long long elapsed = now_ns() - start;
+    cleanup(shared);
+    return elapsed;
+}
+
+/**
+ * @brief Time usleep(arg) sleeps beyond what was asked for
+ */
+static long long bench_usleep_overshoot(int iters, int arg) {
+    long long overshoot = 0;
+    for (int i = 0; i < iters; i++) {
+        long long start = now_ns();
+        usleep(arg);
+        overshoot += now_ns() - start - arg * NS_PER_US;
+    }
+    return overshoot;
+}
+
+/**
+ * @brief Time sleep_until(now + arg) sleeps beyond its deadline
+ */
+static long long bench_deadline_overshoot(int iters, int arg) {
+    long long overshoot = 0;
+    for (int i = 0; i < iters; i++) {
+        overshoot += sleep_until(now_ns() + arg * NS_PER_US);
+    }
+    return overshoot;
+}
+
+// --- Benchmarks, in the order they are reported ---
+static const Bench BENCHES[] = {
+    {"sem ping-pong (round trip)", bench_sem_ping_pong, 0, 20000},
+    {"adaptive ping-pong, no spin", bench_adaptive_ping_pong, 0, 20000},
+    {"adaptive ping-pong, spin", bench_adaptive_ping_pong, ADAPTIVE_SPIN_MAX,
+     20000},
+    {"lock_mutex, 4 processes", bench_contended_mutex, BENCH_MUTEX_WORKERS,
+     40000},
+    {"print_action, 1 writer", bench_print_action, 1, 20000},
+    {"print_action, 8 writers", bench_print_action, 8, 20000},
+    {"print_action, 64 writers", bench_print_action, 64, 20480},
+    {"fork + exit + wait", bench_fork_exit, 0, 200},
+    {"usleep(1) overshoot", bench_usleep_overshoot, 1, 200},
+    {"usleep(100) overshoot", bench_usleep_overshoot, 100, 100},
+    {"usleep(1000) overshoot", bench_usleep_overshoot, 1000, 20},
+    {"deadline +100us overshoot", bench_deadline_overshoot, 100, 100},
+};
+
+/**
+ * @brief Runs one benchmark and prints its row
+ */
+static void run_bench(const Bench *bench, const BenchConfig *bc) {
+    int iters = bench->iters * bc->scale;
+    double sum = 0.0;
+    double sum_sq = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+
+    bench->run(iters, bench->arg);  // Warm-up
+    for (int sample = 0; sample < bc->samples; sample++) {
+        double ns_per_op = (double)bench->run(iters, bench->arg) / iters;
+        sum += ns_per_op;
+        sum_sq += ns_per_op * ns_per_op;
+        min = sample == 0 || ns_per_op < min ? ns_per_op : min;
+        max = sample == 0 || ns_per_op > max ? ns_per_op : max;
+    }
+    double mean = sum / bc->samples;
+    double variance = sum_sq / bc->samples - mean * mean;
+    printf("%-30s %11.1f %10.1f %11.1f %11.1f %8d\n", bench->name, mean,
+           sqrt(variance > 0.0 ? variance : 0.0), min, max, iters);
+    fflush(stdout);
+}
+
+/**
+ * @brief Parses the command line
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ */
+static int parse_bench_args(int argc, char *argv[], BenchConfig *bc) {
+    bc->samples = BENCH_DEFAULT_SAMPLES;
+    bc->scale = 1;
+    bc->filter = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--samples=", 10) == 0) {
+            if (parse_uint(argv[i] + 10, 1, BENCH_MAX_SAMPLES, "samples",
+                           &bc->samples)) {
+                return EXIT_FAILURE;
+            }
+        } else if (strncmp(argv[i], "--scale=", 8) == 0) {
+            if (parse_uint(argv[i] + 8, 1, BENCH_MAX_SCALE, "scale",
+                           &bc->scale)) {
+                return EXIT_FAILURE;
+            }
+        } else if (bc->filter == NULL && argv[i][0] != '-') {
+            bc->filter = argv[i];
+        } else {
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char *argv[]) {
+    BenchConfig bc;
+    if (parse_bench_args(argc, argv, &bc) != EXIT_SUCCESS) {
+        fprintf(stderr, "Usage: %s [filter] [--samples=N] [--scale=N]\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    printf("%ld CPUs online, %d samples per benchmark\n",
+           sysconf(_SC_NPROCESSORS_ONLN), bc.samples);
+    printf("%-30s %11s %10s %11s %11s %8s\n", "benchmark", "ns/op", "stddev",
+           "min", "max", "ops");
+    for (size_t i = 0; i < sizeof(BENCHES) / sizeof(BENCHES[0]); i++) {
+        if (bc.filter == NULL || strstr(BENCHES[i].name, bc.filter)) {
+            run_bench(&BENCHES[i], &bc);
+        }
+    }
+    return EXIT_SUCCESS;
+}
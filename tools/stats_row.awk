@@ -0,0 +1,12 @@
+# Reduces the --stats report of one run to a row of numbers:
+#   veh/s trips/s fill% wait-p99 transit-p50 transit-p99 trips
+# Latencies are in ms. Used by the benchmark scripts.
+/^Vehicles:/ { rate = substr($6, 2) + 0 }
+/^Trips:/ { trips = $2; trips_rate = $(NF - 1) }
+/mean fill/ { fill = $3 + 0 }
+/wait-to-board all/ { wait99 = $6 }
+/transit all/ { p50 = $5; p99 = $6 }
+END {
+    printf "%.1f %.1f %.1f %.3f %.3f %.3f %d\n", rate, trips_rate, fill,
+           wait99, p50, p99, trips
+}
@@ -0,0 +1,434 @@
+/**
+ * Schedule-fuzzing stress harness.
+ *
+ * Runs many short simulations in parallel, each with randomized arguments
+ * and its own --fuzz-seed, and validates every finished log with the
+ * invariant checker. Seeds that stall, crash or produce an invalid log are
+ * reported together with the command line that reproduces them.
+ *
+ * Usage: stress [runs] [jobs] [first_seed] [--bin=path] [--watchdog-ms=N]
+ *        [simulation options...]
+ *
+ * Any other "--" option is passed on to every run, e.g. --policy=fifo.
+ * Logs are checked against the settings the run itself parsed, so options
+ * such as --classes= or --scenario= are taken into account.
+ */
+#include <dirent.h>  // opendir
+#include <limits.h>  // PATH_MAX
+#include <signal.h>  // kill
+
+#include "invariants.h"
+#include "main.h"
+#include "watchdog.h"
+
+// --- Defaults ---
+#define STRESS_DEFAULT_RUNS 1000
+#define STRESS_DEFAULT_WATCHDOG_MS 2000
+#define STRESS_HARD_TIMEOUT_FACTOR 5
+#define STRESS_POLL_US 1000
+#define STRESS_MAX_JOBS 256
+#define STRESS_ARG_LEN 32
+#define STRESS_MAX_EXTRA 16
+#define STRESS_FIXED_ARGS 9  // Program name, five arguments and three options
+#define STRESS_MAX_ARGS (STRESS_FIXED_ARGS + STRESS_MAX_EXTRA)
+
+// --- Randomized parameter ranges ---
+#define STRESS_MAX_VEHICLES 40
+#define STRESS_MAX_CAPACITY 20
+#define STRESS_MAX_VEHICLE_US 200
+#define STRESS_MAX_FERRY_US 50
+
+// --- Structs ---
+typedef struct {
+    int num_trucks;
+    int num_cars;
+    int capacity;
+    int vehicle_us;
+    int ferry_us;
+    int seed;
+} StressParams;
+
+typedef struct {
+    pid_t pid;              // PID of the simulation, 0 if the slot is free
+    long long started;      // Start time of the run
+    char dir[64];           // Working directory of the run
+    StressParams params;    // Arguments of the run
+} StressJob;
+
+typedef struct {
+    char bin[PATH_MAX];     // Absolute path of the simulation binary
+    int runs;               // Number of runs
+    int jobs;               // Runs executed in parallel
+    int first_seed;         // Seed of the first run
+    int watchdog_ms;        // Stall interval passed to each run
+    int failures;           // Failed runs so far
+    const char *extra[STRESS_MAX_EXTRA]; // Options passed on to every run
+    int extra_count;        // Number of extra options
+    char scenario[PATH_MAX + 16]; // --scenario= with an absolute path
+} StressConfig;
+
+/**
+ * @brief Draws a uniformly distributed number in an inclusive range
+ */
+static int draw(int min, int max) {
+    return min + rand() % (max - min + 1);
+}
+
+/**
+ * @brief Parses a positive decimal argument of the harness
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ */
+static int parse_count(const char *value_str, int max, int *result) {
+    char *end;
+    long value = strtol(value_str, &end, PARSE_BASE_DECIMAL);
+    if (*end != '\0' || value < 1 || value > max) {
+        return EXIT_FAILURE;
+    }
+    *result = value;
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Draws the arguments of a run from its seed
+ * @param seed Seed of the run
+ * @return Arguments of the run
+ */
+static StressParams draw_params(int seed) {
+    StressParams params;
+    srand(seed);
+    params.num_trucks = draw(0, STRESS_MAX_VEHICLES);
+    params.num_cars = draw(0, STRESS_MAX_VEHICLES);
+    params.capacity = draw(MIN_CAPACITY_PARCEL, STRESS_MAX_CAPACITY);
+    params.vehicle_us = draw(0, STRESS_MAX_VEHICLE_US);
+    params.ferry_us = draw(0, STRESS_MAX_FERRY_US);
+    params.seed = seed;
+    return params;
+}
+
+/**
+ * @brief Prints the command line reproducing a run
+ */
+static void print_repro(const StressConfig *stress, const StressParams *p) {
+    fprintf(stderr, "  repro: %s %d %d %d %d %d --seed=%d --fuzz-seed=%d",
+            stress->bin, p->num_trucks, p->num_cars, p->capacity,
+            p->vehicle_us, p->ferry_us, p->seed, p->seed);
+    for (int i = 0; i < stress->extra_count; i++) {
+        fprintf(stderr, " %s", stress->extra[i]);
+    }
+    fprintf(stderr, "\n");
+}
+
+/**
+ * @brief Builds the command line of a run
+ * @param stress Harness configuration
+ * @param p Arguments of the run
+ * @param args Storage of the fixed arguments
+ * @param argv Filled with the arguments, NULL terminated
+ * @return Number of arguments
+ */
+static int build_argv(const StressConfig *stress, const StressParams *p,
+                      char args[STRESS_FIXED_ARGS][STRESS_ARG_LEN],
+                      char *argv[STRESS_MAX_ARGS + 1]) {
+    snprintf(args[0], sizeof(args[0]), "%s", "main");
+    snprintf(args[1], sizeof(args[1]), "%d", p->num_trucks);
+    snprintf(args[2], sizeof(args[2]), "%d", p->num_cars);
+    snprintf(args[3], sizeof(args[3]), "%d", p->capacity);
+    snprintf(args[4], sizeof(args[4]), "%d", p->vehicle_us);
+    snprintf(args[5], sizeof(args[5]), "%d", p->ferry_us);
+    snprintf(args[6], sizeof(args[6]), "--seed=%d", p->seed);
+    snprintf(args[7], sizeof(args[7]), "--fuzz-seed=%d", p->seed);
+    snprintf(args[8], sizeof(args[8]), "--watchdog-ms=%d", stress->watchdog_ms);
+    for (int i = 0; i < STRESS_FIXED_ARGS; i++) {
+        argv[i] = args[i];
+    }
+    for (int i = 0; i < stress->extra_count; i++) {
+        argv[STRESS_FIXED_ARGS + i] = (char *)stress->extra[i];
+    }
+    argv[STRESS_FIXED_ARGS + stress->extra_count] = NULL;
+    return STRESS_FIXED_ARGS + stress->extra_count;
+}
+
+/**
+ * @brief Starts one simulation in its own temporary directory
+ * @param stress Harness configuration
+ * @param job Free job slot to fill
+ * @param seed Seed of the run
+ */
+static void start_job(const StressConfig *stress, StressJob *job, int seed) {
+    job->params = draw_params(seed);
+    snprintf(job->dir, sizeof(job->dir), "/tmp/ferry-stress-XXXXXX");
+    if (mkdtemp(job->dir) == NULL) {
+        perror("[ERROR] mkdtemp failed");
+        exit(EXIT_FAILURE);
+    }
+
+    char args[STRESS_FIXED_ARGS][STRESS_ARG_LEN];
+    char *argv[STRESS_MAX_ARGS + 1];
+    build_argv(stress, &job->params, args, argv);
+
+    job->started = now_ns();
+    job->pid = fork();
+    if (job->pid == 0) {
+        // Own process group, so a hard timeout can kill the run
+        setpgid(0, 0);
+        if (chdir(job->dir) == -1 ||
+            freopen("stderr.txt", "w", stderr) == NULL ||
+            freopen("/dev/null", "w", stdout) == NULL) {
+            _exit(EXIT_FAILURE);
+        }
+        execv(stress->bin, argv);
+        _exit(EXIT_FAILURE);
+    } else if (job->pid < 0) {
+        fprintf(stderr, "[ERROR] fork failed\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * @brief Removes the temporary directory of a passed run
+ */
+static void remove_job_dir(StressJob *job) {
+    char path[sizeof(job->dir) + 16];
+    snprintf(path, sizeof(path), "%s/proj2.out", job->dir);
+    unlink(path);
+    snprintf(path, sizeof(path), "%s/stderr.txt", job->dir);
+    unlink(path);
+    rmdir(job->dir);
+}
+
+/**
+ * @brief Classifies a finished run and reports it if it failed
+ * @param stress Harness configuration
+ * @param job The finished job
+ * @param status Wait status of the simulation, -1 for a hard timeout
+ */
+static void finish_job(StressConfig *stress, StressJob *job, int status) {
+    char reason[INVARIANT_ERROR_LEN + 32] = "";
+    char path[sizeof(job->dir) + 16];
+    // The same settings the run parsed, classes and round trips included
+    char args[STRESS_FIXED_ARGS][STRESS_ARG_LEN];
+    char *argv[STRESS_MAX_ARGS + 1];
+    int argc = build_argv(stress, &job->params, args, argv);
+    Config cfg;
+    int rejected = parse_args(argc, (char const **)argv, &cfg) ||
+                   config_validate(&cfg);
+
+    if (status == -1) {
+        snprintf(reason, sizeof(reason), "hard timeout");
+    } else if (WIFSIGNALED(status)) {
+        snprintf(reason, sizeof(reason), "killed by signal %d",
+                 WTERMSIG(status));
+    } else if (rejected) {
+        snprintf(reason, sizeof(reason), "arguments rejected");
+    } else if (WEXITSTATUS(status) != EXIT_SUCCESS) {
+        snprintf(reason, sizeof(reason), "exit status %d (stall?)",
+                 WEXITSTATUS(status));
+    } else {
+        snprintf(path, sizeof(path), "%s/proj2.out", job->dir);
+        FILE *log = fopen(path, "r");
+        char error[INVARIANT_ERROR_LEN];
+        if (log == NULL) {
+            snprintf(reason, sizeof(reason), "no proj2.out");
+        } else {
+            if (invariant_check_file(log, &cfg.classes,
+                                     cfg.capacity_of_ferry, cfg.crossings,
+                                     error, sizeof(error))) {
+                snprintf(reason, sizeof(reason), "invalid log: %s", error);
+            }
+            fclose(log);
+        }
+    }
+
+    if (reason[0] == '\0') {
+        remove_job_dir(job);
+    } else {
+        stress->failures++;
+        fprintf(stderr, "[FAIL] seed %d: %s, output kept in %s\n",
+                job->params.seed, reason, job->dir);
+        print_repro(stress, &job->params);
+    }
+    job->pid = 0;
+}
+
+/**
+ * @brief Parses the harness arguments
+ * @return EXIT_SUCCESS if successful, EXIT_FAILURE otherwise
+ */
+static int parse_stress_args(int argc, char *argv[], StressConfig *stress) {
+    const char *bin = "build/main";
+    int positional = 0;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+    stress->runs = STRESS_DEFAULT_RUNS;
+    stress->jobs = cpus > 0 ? (int)cpus : 1;
+    stress->first_seed = 1;
+    stress->watchdog_ms = STRESS_DEFAULT_WATCHDOG_MS;
+    stress->failures = 0;
+    stress->extra_count = 0;
+
+    for (int i = 1; i < argc; i++) {
+        int failed = 0;
+        if (strncmp(argv[i], "--bin=", 6) == 0) {
+            bin = argv[i] + 6;
+        } else if (strncmp(argv[i], "--watchdog-ms=", 14) == 0) {
+            failed = parse_count(argv[i] + 14, MAX_WATCHDOG_MS,
+                                 &stress->watchdog_ms);
+        } else if (strncmp(argv[i], "--", 2) == 0) {
+            failed = stress->extra_count == STRESS_MAX_EXTRA;
+            if (!failed) {
+                stress->extra[stress->extra_count++] = argv[i];
+            }
+            // Runs start in their own directory
+            char scenario[PATH_MAX];
+            if (!failed && strncmp(argv[i], "--scenario=", 11) == 0) {
+                if (realpath(argv[i] + 11, scenario) == NULL) {
+                    fprintf(stderr, "[ERROR] Scenario %s not found\n",
+                            argv[i] + 11);
+                    return EXIT_FAILURE;
+                }
+                snprintf(stress->scenario, sizeof(stress->scenario),
+                         "--scenario=%s", scenario);
+                stress->extra[stress->extra_count - 1] = stress->scenario;
+            }
+        } else if (positional == 0) {
+            failed = parse_count(argv[i], INT_MAX, &stress->runs);
+            positional++;
+        } else if (positional == 1) {
+            failed = parse_count(argv[i], STRESS_MAX_JOBS, &stress->jobs);
+            positional++;
+        } else if (positional == 2) {
+            failed = parse_count(argv[i], RAND_MAX, &stress->first_seed);
+            positional++;
+        } else {
+            failed = 1;
+        }
+        if (failed) {
+            fprintf(stderr,
+                    "Usage: %s [runs] [jobs] [first_seed] [--bin=path] "
+                    "[--watchdog-ms=N] [simulation options...]\n",
+                    argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (realpath(bin, stress->bin) == NULL) {
+        fprintf(stderr, "[ERROR] Simulation binary %s not found\n", bin);
+        return EXIT_FAILURE;
+    }
+    // Reject bad simulation options once instead of failing every run
+    StressParams params = draw_params(stress->first_seed);
+    char fixed[STRESS_FIXED_ARGS][STRESS_ARG_LEN];
+    char *run_argv[STRESS_MAX_ARGS + 1];
+    int run_argc = build_argv(stress, &params, fixed, run_argv);
+    Config cfg;
+    if (parse_args(run_argc, (char const **)run_argv, &cfg) ||
+        config_validate(&cfg)) {
+        fprintf(stderr, "[ERROR] Invalid simulation options\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Kills the process groups of a process's descendants
+ * @param pid Process whose children are walked, via /proc/PID/task/TID/children
+ * @param job_pgid Group of the job, killed by the caller
+ *
+ * Under the watchdog or the checker the ferry leads a group of its own
+ * that the vehicles and port servers join, so killing the job's group
+ * alone would leave them running.
+ */
+static void kill_descendant_groups(pid_t pid, pid_t job_pgid) {
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/task", (int)pid);
+    DIR *tasks = opendir(path);
+    if (tasks == NULL) {
+        return;
+    }
+    struct dirent *task;
+    while ((task = readdir(tasks)) != NULL) {
+        if (task->d_name[0] == '.') {
+            continue;
+        }
+        snprintf(path, sizeof(path), "/proc/%d/task/%.16s/children", (int)pid,
+                 task->d_name);
+        FILE *children = fopen(path, "r");
+        if (children == NULL) {
+            continue;
+        }
+        int child;
+        while (fscanf(children, "%d", &child) == 1) {
+            pid_t group = getpgid(child);
+            if (group > 0 && group != job_pgid) {
+                kill(-group, SIGSTOP);
+            }
+            kill_descendant_groups(child, job_pgid);
+            if (group > 0 && group != job_pgid) {
+                kill(-group, SIGKILL);
+            }
+        }
+        fclose(children);
+    }
+    closedir(tasks);
+}
+
+/**
+ * @brief Reaps finished runs and kills runs past the hard timeout
+ * @return Number of jobs that were freed
+ */
+static int reap_jobs(StressConfig *stress, StressJob *jobs) {
+    long long hard_timeout_ns =
+        stress->watchdog_ms * NS_PER_MS * STRESS_HARD_TIMEOUT_FACTOR;
+    int freed = 0;
+
+    for (int slot = 0; slot < stress->jobs; slot++) {
+        StressJob *job = &jobs[slot];
+        int status;
+        if (job->pid == 0) {
+            continue;
+        }
+        if (waitpid(job->pid, &status, WNOHANG) == job->pid) {
+            finish_job(stress, job, status);
+            freed++;
+        } else if (now_ns() - job->started > hard_timeout_ns) {
+            // Stop the job first so it cannot fork while its tree is walked
+            kill(-job->pid, SIGSTOP);
+            kill_descendant_groups(job->pid, job->pid);
+            kill(-job->pid, SIGKILL);
+            waitpid(job->pid, &status, 0);
+            finish_job(stress, job, -1);
+            freed++;
+        }
+    }
+    return freed;
+}
+
+int main(int argc, char *argv[]) {
+    StressConfig stress;
+    if (parse_stress_args(argc, argv, &stress) != EXIT_SUCCESS) {
+        return EXIT_FAILURE;
+    }
+    StressJob jobs[STRESS_MAX_JOBS] = {{0}};
+    long long started = now_ns();
+    int launched = 0;
+    int finished = 0;
+
+    while (finished < stress.runs) {
+        for (int slot = 0; slot < stress.jobs && launched < stress.runs;
+             slot++) {
+            if (jobs[slot].pid == 0) {
+                start_job(&stress, &jobs[slot], stress.first_seed + launched);
+                launched++;
+            }
+        }
+        int freed = reap_jobs(&stress, jobs);
+        finished += freed;
+        if (freed == 0) {
+            usleep(STRESS_POLL_US);
+        }
+    }
+
+    double seconds = (double)(now_ns() - started) / NS_PER_SEC;
+    printf("%d runs, %d failed, %.1f s (%.1f runs/s)\n", stress.runs,
+           stress.failures, seconds, stress.runs / seconds);
+    return stress.failures > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}